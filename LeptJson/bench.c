@@ -0,0 +1,1282 @@
+// ܲԣ: make bench  cc -O2 bench.c leptjson.c -lm -pthread  cl /O2 bench.c leptjson.c
+// ÷: bench []ʱȫ
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include "leptjson.h"
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "psapi.lib")
+#endif
+#elif !defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+typedef struct {
+	char* s;
+	size_t len, size;
+} bench_buffer;
+
+static void bench_append(bench_buffer* b, const char* s) {
+	size_t len = strlen(s);
+	if (b->len + len + 1 > b->size) {
+		while (b->len + len + 1 > b->size)
+			b->size = b->size ? b->size * 2 : 256;
+		b->s = (char*)realloc(b->s, b->size);
+	}
+	memcpy(b->s + b->len, s, len + 1);
+	b->len += len;
+}
+
+static double bench_now() {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// ̵߳ʱclock()̼߳CPUʱ䣬Ҫǽʱ
+static double bench_wall() {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// һ͵壬records¼ÿ¼мַֺһС
+static char* bench_make_request(int records) {
+	bench_buffer b = { NULL, 0, 0 };
+	char item[256];
+	int i;
+	bench_append(&b, "{\"id\":\"req-000001\",\"user\":{\"name\":\"alice\",\"roles\":[\"admin\",\"dev\"]},\"items\":[");
+	for (i = 0; i < records; i++) {
+		sprintf(item, "%s{\"sku\":\"SKU-%05d\",\"qty\":%d,\"price\":%d.%02d,\"tags\":[\"a\",\"b\",\"c\"],\"note\":\"item number %d\"}",
+			i > 0 ? "," : "", i, i % 7 + 1, 10 + i % 90, i % 100, i);
+		bench_append(&b, item);
+	}
+	bench_append(&b, "]}");
+	return b.s;
+}
+
+// ͳһͨģʽҪٴmallocÿַÿÿǿյͶһ
+// shortΪ1ʱֱӴֵͳԱĶַͶ̼
+static size_t bench_count_allocs(const lept_value* v, int short_inline) {
+	size_t i, n = 0;
+	switch (lept_get_type(v)) {
+	case LEPT_STRING:
+		return !(short_inline && lept_get_string_length(v) <= LEPT_SHORT_STRING_MAX);
+	case LEPT_ARRAY:
+		for (i = 0; i < lept_get_array_size(v); i++)
+			n += bench_count_allocs(lept_get_array_element(v, i), short_inline);
+		return n + (lept_get_array_size(v) > 0);
+	case LEPT_OBJECT:
+		for (i = 0; i < lept_get_object_size(v); i++)
+			n += !(short_inline && lept_get_object_key_length(v, i) <= LEPT_SHORT_KEY_MAX) +
+				bench_count_allocs(lept_get_object_value(v, i), short_inline);
+		return n + (lept_get_object_size(v) > 0);
+	default:
+		return 0;
+	}
+}
+
+static void bench_arena() {
+	const int docs = 100000;
+	char* json = bench_make_request(8);
+	lept_arena a;
+	lept_value v;
+	size_t allocs;
+	double t;
+	int i;
+
+	printf("arena: %d docs, %d bytes each\n", docs, (int)strlen(json));
+	lept_parse(&v, json);
+	allocs = bench_count_allocs(&v, 1);
+	lept_free(&v);
+
+	t = bench_now();
+	for (i = 0; i < docs; i++) {
+		lept_parse(&v, json);
+		lept_free(&v);
+	}
+	printf("  lept_parse + lept_free       : %8.3f s, %d allocs/doc\n", bench_now() - t, (int)allocs);
+
+	lept_arena_init(&a);
+	t = bench_now();
+	for (i = 0; i < docs; i++) {
+		lept_parse_arena(&v, json, &a);
+		lept_arena_reset(&a);
+	}
+	printf("  lept_parse_arena + reset     : %8.3f s, %d blocks held\n", bench_now() - t, (int)a.blocks);
+	lept_arena_free(&a);
+	free(json);
+}
+
+// ĸʽjsonַȽϳûת
+static char* bench_make_pretty(int records) {
+	bench_buffer b = { NULL, 0, 0 };
+	char item[512];
+	int i;
+	bench_append(&b, "{\n    \"records\": [\n");
+	for (i = 0; i < records; i++) {
+		sprintf(item,
+			"        {\n"
+			"            \"id\": %d,\n"
+			"            \"title\": \"The quick brown fox jumps over the lazy dog, record %d\",\n"
+			"            \"body\": \"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore\",\n"
+			"            \"flags\": [\n                true,\n                false\n            ]\n"
+			"        }%s\n", i, i, i + 1 < records ? "," : "");
+		bench_append(&b, item);
+	}
+	bench_append(&b, "    ]\n}\n");
+	return b.s;
+}
+
+static void bench_scan() {
+	const int loops = 200;
+	char* json = bench_make_pretty(2000);
+	size_t len = strlen(json);
+	lept_value v;
+	double t;
+	int i;
+
+	t = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse(&v, json);
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	printf("scan: pretty-printed, %d bytes\n", (int)len);
+	printf("  lept_parse + lept_free       : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+	free(json);
+}
+
+// ң飬һһĸ
+static char* bench_make_numbers(int count) {
+	bench_buffer b = { NULL, 0, 0 };
+	char item[64];
+	unsigned seed = 12345;
+	int i;
+	bench_append(&b, "[");
+	for (i = 0; i < count; i++) {
+		seed = seed * 1103515245 + 12345;
+		if (i % 2)
+			sprintf(item, "%s%u", i > 0 ? "," : "", seed % 100000);
+		else
+			sprintf(item, "%s%.17g", i > 0 ? "," : "", (seed / 65536) * 1.1e-3 - 17.0);
+		bench_append(&b, item);
+	}
+	bench_append(&b, "]");
+	return b.s;
+}
+
+static void bench_number() {
+	const int loops = 50;
+	char* json = bench_make_numbers(200000);
+	size_t len = strlen(json);
+	lept_value v;
+	double t, sum = 0;
+	char* p;
+	int i;
+
+	t = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse(&v, json);
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	printf("number: 200000 numbers, %d bytes\n", (int)len);
+	printf("  lept_parse + lept_free       : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+
+	// ֻstrtodͬתһ飬Ϊ
+	t = bench_now();
+	for (i = 0; i < loops; i++)
+		for (p = json + 1; *p; p++)
+			sum += strtod(p, &p);
+	t = bench_now() - t;
+	printf("  strtod only                  : %8.3f s, %.1f MB/s (%g)\n", t, len * (double)loops / t / (1024 * 1024), sum);
+	free(json);
+}
+
+static void bench_dtoa() {
+	const int loops = 20;
+	char* json = bench_make_numbers(200000);
+	char* out;
+	char buffer[32];
+	size_t i, len, n;
+	lept_value v;
+	double t;
+	int k;
+
+	lept_parse(&v, json);
+	n = lept_get_array_size(&v);
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		lept_stringify(&v, &out, &len);
+		free(out);
+	}
+	t = bench_now() - t;
+	printf("dtoa: %d numbers, %d bytes of output\n", (int)n, (int)len);
+	printf("  lept_stringify               : %8.3f s, %.1f ns/number\n", t, t * 1e9 / loops / n);
+
+	// ֮ǰʵֶÿֵһsprintf("%.17g")
+	t = bench_now();
+	for (k = 0; k < loops; k++)
+		for (i = 0; i < n; i++)
+			sprintf(buffer, "%.17g", lept_get_number(lept_get_array_element(&v, i)));
+	t = bench_now() - t;
+	printf("  sprintf(\"%%.17g\") only       : %8.3f s, %.1f ns/number\n", t, t * 1e9 / loops / n);
+	lept_free(&v);
+	free(json);
+}
+
+// ҳԱϹϣɨĶԱ
+static void bench_find() {
+	const int members = 500, loops = 2000;
+	bench_buffer b = { NULL, 0, 0 };
+	char item[64], (*keys)[16] = (char(*)[16])malloc(members * sizeof(*keys));
+	lept_value v;
+	size_t i, j, found = 0;
+	double t;
+	int k;
+
+	bench_append(&b, "{");
+	for (k = 0; k < members; k++) {
+		sprintf(keys[k], "field_%04d", k);
+		sprintf(item, "%s\"%s\":%d", k > 0 ? "," : "", keys[k], k);
+		bench_append(&b, item);
+	}
+	bench_append(&b, "}");
+	lept_parse(&v, b.s);
+	printf("find: object with %d members, %d lookups\n", members, members * loops);
+
+	t = bench_now();
+	for (k = 0; k < loops; k++)
+		for (i = 0; i < (size_t)members; i++)
+			found += lept_find_object_index(&v, keys[i], 10);
+	printf("  lept_find_object_index       : %8.3f s\n", bench_now() - t);
+
+	t = bench_now();
+	for (k = 0; k < loops; k++)
+		for (i = 0; i < (size_t)members; i++)
+			for (j = 0; j < lept_get_object_size(&v); j++)
+				if (lept_get_object_key_length(&v, j) == 10 && memcmp(lept_get_object_key(&v, j), keys[i], 10) == 0) {
+					found += j;
+					break;
+				}
+	printf("  linear scan + memcmp         : %8.3f s (%d)\n", bench_now() - t, (int)(found % 1000));
+	lept_free(&v);
+	free(keys);
+	free(b.s);
+}
+
+// SAXۺϣ"qty"ֶ
+typedef struct {
+	int in_qty;
+	double sum;
+} bench_sax_sum;
+
+static int bench_sax_key(void* user, const char* k, size_t klen) {
+	((bench_sax_sum*)user)->in_qty = klen == 3 && memcmp(k, "qty", 3) == 0;
+	return 1;
+}
+
+static int bench_sax_number(void* user, double n) {
+	bench_sax_sum* s = (bench_sax_sum*)user;
+	if (s->in_qty)
+		s->sum += n;
+	return 1;
+}
+
+static void bench_sax() {
+	const int loops = 10;
+	char* json = bench_make_request(100000);
+	size_t i, len = strlen(json);
+	lept_sax_handler h;
+	bench_sax_sum sum;
+	lept_value v, *items;
+	double t, dom_sum = 0;
+	int k;
+
+	memset(&h, 0, sizeof(h));
+	h.key = bench_sax_key;
+	h.number = bench_sax_number;
+	printf("sax: sum of \"qty\" over %d bytes\n", (int)len);
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		sum.in_qty = 0;
+		sum.sum = 0;
+		lept_parse_sax(json, &h, &sum);
+	}
+	t = bench_now() - t;
+	printf("  lept_parse_sax               : %8.3f s, %.1f MB/s (%g)\n", t, len * (double)loops / t / (1024 * 1024), sum.sum);
+
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		lept_parse(&v, json);
+		items = lept_find_object_value(&v, "items", 5);
+		dom_sum = 0;
+		for (i = 0; i < lept_get_array_size(items); i++)
+			dom_sum += lept_get_number(lept_find_object_value(lept_get_array_element(items, i), "qty", 3));
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	printf("  lept_parse + walk + free     : %8.3f s, %.1f MB/s (%g)\n", t, len * (double)loops / t / (1024 * 1024), dom_sum);
+	free(json);
+}
+
+// socketյһ4Kһιȥ
+static void bench_feed() {
+	const int loops = 10;
+	const size_t chunk = 4096;
+	char* json = bench_make_request(100000);
+	size_t i, len = strlen(json);
+	lept_parser p;
+	lept_value v;
+	double t;
+	int k;
+
+	printf("feed: %d bytes, %d-byte chunks\n", (int)len, (int)chunk);
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		lept_parse(&v, json);
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	printf("  lept_parse + lept_free       : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+
+	lept_parser_init(&p);
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		for (i = 0; i < len; i += chunk)
+			lept_parser_feed(&p, json + i, len - i < chunk ? len - i : chunk);
+		lept_parser_finish(&p, &v);
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	printf("  lept_parser_feed + finish    : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+	lept_parser_free(&p);
+	free(json);
+}
+
+// ļǰһٽַдȥ
+static void bench_file() {
+	const int loops = 5;
+	const char* path = "bench_file.json";
+	char* json = bench_make_request(100000);
+	char *buf, *out;
+	size_t len = strlen(json), n;
+	lept_value v;
+	FILE* fp;
+	double t;
+	int k;
+
+	fp = fopen(path, "wb");
+	fwrite(json, 1, len, fp);
+	fclose(fp);
+	free(json);
+	printf("file: %d bytes\n", (int)len);
+
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		fp = fopen(path, "rb");
+		buf = (char*)malloc(len + 1);
+		n = fread(buf, 1, len, fp);
+		buf[n] = '\0';
+		fclose(fp);
+		lept_parse(&v, buf);
+		free(buf);
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	printf("  fread + lept_parse           : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		lept_parse_file(&v, path);
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	printf("  lept_parse_file              : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+
+	lept_parse_file(&v, path);
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		fp = fopen(path, "wb");
+		lept_stringify(&v, &out, &n);
+		fwrite(out, 1, n, fp);
+		free(out);
+		fclose(fp);
+	}
+	t = bench_now() - t;
+	printf("  lept_stringify + fwrite      : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		fp = fopen(path, "wb");
+		lept_stringify_file(&v, fp);
+		fclose(fp);
+	}
+	t = bench_now() - t;
+	printf("  lept_stringify_file          : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+	lept_free(&v);
+	remove(path);
+}
+
+// صֻһֽ൱ڽwritev֮Ͼͷ
+static int bench_sink_count(void* user, const char* s, size_t len) {
+	*(size_t*)user += len;
+	return s != NULL;
+}
+
+static void bench_sink() {
+	const int loops = 20;
+	char* json = bench_make_request(100000);
+	char* out;
+	size_t len, total = 0;
+	lept_value v;
+	double t;
+	int k;
+
+	lept_parse(&v, json);
+	free(json);
+	t = bench_now();
+	for (k = 0; k < loops; k++) {
+		lept_stringify(&v, &out, &len);
+		free(out);
+	}
+	t = bench_now() - t;
+	printf("sink: %d bytes of output\n", (int)len);
+	printf("  lept_stringify               : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+
+	t = bench_now();
+	for (k = 0; k < loops; k++)
+		lept_stringify_sink(&v, 65536, bench_sink_count, &total);
+	t = bench_now() - t;
+	printf("  lept_stringify_sink (64K)    : %8.3f s, %.1f MB/s (%d)\n", t, len * (double)loops / t / (1024 * 1024), (int)(total / loops));
+	lept_free(&v);
+}
+
+// ֱparsefreestringifyһͨ壬һǶ׺
+static void bench_nest_run(const char* name, const char* json, int loops) {
+	size_t len = strlen(json), n;
+	lept_value v;
+	char* out;
+	double tp = 0, tf = 0, ts = 0, t;
+	int k;
+	for (k = 0; k < loops; k++) {
+		t = bench_now();
+		lept_parse(&v, json);
+		tp += bench_now() - t;
+		t = bench_now();
+		lept_stringify(&v, &out, &n);
+		ts += bench_now() - t;
+		free(out);
+		t = bench_now();
+		lept_free(&v);
+		tf += bench_now() - t;
+	}
+	printf("  %-8s parse %6.1f MB/s, stringify %6.1f MB/s, free %8.3f s\n", name,
+		len * (double)loops / tp / (1024 * 1024), len * (double)loops / ts / (1024 * 1024), tf);
+}
+
+static void bench_nest() {
+	const int depth = 500;
+	bench_buffer b = { NULL, 0, 0 };
+	char* json = bench_make_request(100000);
+	int i, j;
+	printf("nest: request body and arrays nested %d deep\n", depth);
+	bench_nest_run("request", json, 10);
+	free(json);
+	bench_append(&b, "[");
+	for (i = 0; i < 2000; i++) {
+		bench_append(&b, i ? "," : "");
+		for (j = 0; j < depth; j++)
+			bench_append(&b, "[");
+		bench_append(&b, "1");
+		for (j = 0; j < depth; j++)
+			bench_append(&b, "]");
+	}
+	bench_append(&b, "]");
+	bench_nest_run("deep", b.s, 10);
+	free(b.s);
+}
+
+// ܶСĵÿ·ʱջ͸lept_parser/lept_writerĻȽ
+static void bench_reuse() {
+	static const char* docs[] = {
+		"{\"id\":12345,\"name\":\"alice\",\"tags\":[\"a\",\"b\"],\"ok\":true}",
+		"[1,2,3,4,5,6,7,8]",
+		"{\"event\":\"click\",\"x\":10.5,\"y\":-3,\"meta\":{\"k\":null}}",
+		"\"just a string\""
+	};
+	const int loops = 500000, n = sizeof(docs) / sizeof(docs[0]);
+	size_t lens[4], total = 0, length;
+	lept_parser p;
+	lept_writer w;
+	lept_value v;
+	const char* out;
+	char* json;
+	double t0, t1, t2, t3;
+	int i;
+	for (i = 0; i < n; i++)
+		total += lens[i] = strlen(docs[i]);
+	total *= loops / n;
+	lept_parser_init(&p);
+	lept_writer_init(&w);
+	printf("reuse: %d small documents\n", loops);
+
+	t0 = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse_n(&v, docs[i % n], lens[i % n]);
+		lept_free(&v);
+	}
+	t1 = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parser_parse(&p, &v, docs[i % n], lens[i % n]);
+		lept_free(&v);
+	}
+	t2 = bench_now();
+	printf("  parse      lept_parse_n %6.1f MB/s, lept_parser_parse %6.1f MB/s\n",
+		total / (t1 - t0) / (1024 * 1024), total / (t2 - t1) / (1024 * 1024));
+
+	lept_parse(&v, docs[0]);
+	t0 = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_stringify(&v, &json, &length);
+		free(json);
+	}
+	t1 = bench_now();
+	for (i = 0; i < loops; i++)
+		lept_writer_stringify(&w, &v, &out, &length);
+	t2 = bench_now();
+	t3 = length * (double)loops / (1024 * 1024);
+	printf("  stringify  lept_stringify %6.1f MB/s, lept_writer_stringify %6.1f MB/s\n",
+		t3 / (t1 - t0), t3 / (t2 - t1));
+	lept_free(&v);
+	lept_parser_free(&p);
+	lept_writer_free(&w);
+}
+
+static void bench_structural_run(const char* name, const char* json, int loops) {
+	size_t len = strlen(json);
+	lept_value v;
+	double t0, t1, t2;
+	int i;
+	t0 = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse_n(&v, json, len);
+		lept_free(&v);
+	}
+	t1 = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse_structural(&v, json, len);
+		lept_free(&v);
+	}
+	t2 = bench_now();
+	printf("  %-8s %9d bytes  lept_parse_n %7.1f MB/s, lept_parse_structural %7.1f MB/s\n", name, (int)len,
+		len * (double)loops / (t1 - t0) / (1024 * 1024), len * (double)loops / (t2 - t1) / (1024 * 1024));
+}
+
+// ׶νֽڽȽϣlept_free
+static void bench_structural() {
+	bench_buffer b = { NULL, 0, 0 };
+	char* json, *s;
+	FILE* fp;
+	int i;
+	printf("structural: two-stage parse\n");
+	if ((fp = fopen("origin.txt", "rb")) != NULL) {
+		json = (char*)malloc(1 << 16);
+		json[fread(json, 1, (1 << 16) - 1, fp)] = '\0';
+		fclose(fp);
+		bench_structural_run("origin", json, 100000);
+		free(json);
+	}
+	json = bench_make_pretty(2000);
+	bench_structural_run("pretty", json, 100);
+	free(json);
+	json = bench_make_request(100000);
+	bench_structural_run("request", json, 20);
+	free(json);
+	json = bench_make_numbers(200000);
+	bench_structural_run("numbers", json, 20);
+	free(json);
+	// ַܳ
+	s = (char*)malloc(1003);
+	memset(s, 'x', 1003);
+	s[0] = s[1001] = '\"';
+	s[1002] = '\0';
+	bench_append(&b, "[");
+	for (i = 0; i < 5000; i++) {
+		bench_append(&b, i ? "," : "");
+		bench_append(&b, s);
+	}
+	bench_append(&b, "]");
+	bench_structural_run("strings", b.s, 50);
+	free(b.s);
+	free(s);
+}
+
+// һ200KBҵֶֻ
+static double bench_lazy_run(int (*parse)(lept_value*, const char*, size_t), const char* json, size_t len, int loops) {
+	lept_value v;
+	size_t n = 0;
+	double t = bench_now();
+	int i;
+	for (i = 0; i < loops; i++) {
+		parse(&v, json, len);
+		n += lept_get_string_length(lept_find_object_value(&v, "id", 2));
+		n += lept_get_string_length(lept_find_object_value(lept_find_object_value(&v, "user", 4), "name", 4));
+		n += lept_get_string_length(lept_find_object_value(lept_get_array_element(lept_find_object_value(&v, "items", 5), 1000), "sku", 3));
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	if (n != (size_t)loops * 24)
+		printf("  wrong result\n");
+	return t;
+}
+
+static void bench_lazy() {
+	const int loops = 1000;
+	char* json = bench_make_request(2000);
+	size_t len = strlen(json);
+	double t1 = bench_lazy_run(lept_parse_n, json, len, loops), t2 = bench_lazy_run(lept_parse_lazy, json, len, loops);
+	printf("lazy: read 3 fields from a %d-byte document\n", (int)len);
+	printf("  lept_parse_n    : %8.3f s, %.1f MB/s\n", t1, len * (double)loops / t1 / (1024 * 1024));
+	printf("  lept_parse_lazy : %8.3f s, %.1f MB/s\n", t2, len * (double)loops / t2 / (1024 * 1024));
+	free(json);
+}
+
+// ַֺĳȼҪһָ
+static double bench_tape_walk_value(const lept_value* v) {
+	double sum = 0;
+	size_t i;
+	switch (lept_get_type(v)) {
+	case LEPT_NUMBER: return lept_get_number(v);
+	case LEPT_STRING: return (double)lept_get_string_length(v);
+	case LEPT_ARRAY:
+		for (i = 0; i < lept_get_array_size(v); i++)
+			sum += bench_tape_walk_value(lept_get_array_element(v, i));
+		return sum;
+	case LEPT_OBJECT:
+		for (i = 0; i < lept_get_object_size(v); i++)
+			sum += lept_get_object_key_length(v, i) + bench_tape_walk_value(lept_get_object_value(v, i));
+		return sum;
+	default: return 0;
+	}
+}
+
+// tape˳ɨһˣҲַ
+static double bench_tape_walk_tape(const lept_tape* t) {
+	double sum = 0;
+	size_t i;
+	for (i = 0; i < t->size; ) {
+		switch (lept_tape_get_type(t, i)) {
+		case LEPT_NUMBER: sum += lept_tape_get_number(t, i); i += 2; break;
+		case LEPT_STRING: sum += lept_tape_get_string_length(t, i); i++; break;
+		case LEPT_ARRAY:
+		case LEPT_OBJECT: i += 2; break;
+		default: i++; break;
+		}
+	}
+	return sum;
+}
+
+// ͽtapeٸԱһ
+static void bench_tape() {
+	const int loops = 10, walks = 50;
+	char* json = bench_make_request(100000);
+	size_t len = strlen(json);
+	lept_value v;
+	lept_tape t;
+	double t0, t1, t2, t3, t4, s1 = 0, s2 = 0;
+	int i;
+	lept_tape_init(&t);
+	t0 = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse_n(&v, json, len);
+		lept_free(&v);
+	}
+	t1 = bench_now();
+	for (i = 0; i < loops; i++)
+		lept_parse_tape(&t, json, len);
+	t2 = bench_now();
+	lept_parse_n(&v, json, len);
+	for (i = 0; i < walks; i++)
+		s1 += bench_tape_walk_value(&v);
+	t3 = bench_now();
+	for (i = 0; i < walks; i++)
+		s2 += bench_tape_walk_tape(&t);
+	t4 = bench_now();
+	if (s1 != s2)
+		printf("  wrong result\n");
+	printf("tape: %d-byte document, tape %d words + %d bytes of strings\n", (int)len, (int)t.size, (int)t.string_size);
+	printf("  parse  lept_parse_n %7.1f MB/s, lept_parse_tape %7.1f MB/s\n",
+		len * (double)loops / (t1 - t0) / (1024 * 1024), len * (double)loops / (t2 - t1) / (1024 * 1024));
+	printf("  walk   tree %8.3f s, tape %8.3f s\n", t3 - t2, t4 - t3);
+	lept_free(&v);
+	lept_tape_free(&t);
+	free(json);
+}
+
+// 󲿷ַ״̬롢IDĶַҲܶ
+static void bench_short() {
+	const int records = 100000, loops = 10;
+	static const char* status[] = { "OK", "PENDING", "FAILED", "REFUNDED" };
+	bench_buffer b = { NULL, 0, 0 };
+	char item[256];
+	lept_value v;
+	double t;
+	int i;
+	bench_append(&b, "[");
+	for (i = 0; i < records; i++) {
+		sprintf(item, "%s{\"id\":\"ORD%07d\",\"st\":\"%s\",\"cur\":\"USD\",\"qty\":%d,\"sku\":\"SKU-%05d\",\"tags\":[\"new\",\"gift\"]}",
+			i ? "," : "", i, status[i % 4], i % 10, i % 50000);
+		bench_append(&b, item);
+	}
+	bench_append(&b, "]");
+	lept_parse_n(&v, b.s, b.len);
+	printf("short: %d records, %d bytes, %d allocs without inline strings, %d with\n", records, (int)b.len,
+		(int)bench_count_allocs(&v, 0), (int)bench_count_allocs(&v, 1));
+	lept_free(&v);
+	t = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse_n(&v, b.s, b.len);
+		lept_free(&v);
+	}
+	t = bench_now() - t;
+	printf("  lept_parse_n + lept_free     : %8.3f s, %.1f MB/s\n", t, b.len * (double)loops / t / (1024 * 1024));
+	free(b.s);
+}
+
+// ¼飬ÿ¼ļһҶȽϳ
+static void bench_intern() {
+	const int records = 100000, loops = 10;
+	bench_buffer b = { NULL, 0, 0 };
+	char item[256];
+	lept_intern t;
+	lept_value v;
+	double t0, t1, t2;
+	size_t allocs;
+	int i;
+	bench_append(&b, "[");
+	for (i = 0; i < records; i++) {
+		sprintf(item, "%s{\"customer_id\":%d,\"created_at\":%d,\"is_active\":true,\"description\":null,\"shipping_address\":{\"postal_code\":%d}}",
+			i ? "," : "", i, 1600000000 + i, i % 100000);
+		bench_append(&b, item);
+	}
+	bench_append(&b, "]");
+	lept_parse_n(&v, b.s, b.len);
+	allocs = bench_count_allocs(&v, 1);
+	lept_free(&v);
+	lept_intern_init(&t);
+	t0 = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse_n(&v, b.s, b.len);
+		lept_free(&v);
+	}
+	t1 = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_parse_intern(&v, b.s, b.len, &t);
+		lept_free(&v);
+	}
+	t2 = bench_now();
+	// ÿ¼6ñ֮ĵֻǼ
+	printf("intern: %d records, %d bytes, %d allocs without the table, %d with (%d keys in the table)\n", records, (int)b.len,
+		(int)allocs, (int)(allocs - records * 6 + t.size), (int)t.size);
+	printf("  lept_parse_n + lept_free      : %8.3f s, %.1f MB/s\n", t1 - t0, b.len * (double)loops / (t1 - t0) / (1024 * 1024));
+	printf("  lept_parse_intern + lept_free : %8.3f s, %.1f MB/s\n", t2 - t1, b.len * (double)loops / (t2 - t1) / (1024 * 1024));
+	lept_intern_free(&t);
+	free(b.s);
+}
+
+typedef struct {
+	char* order_id;
+	struct { char* name; char* email; } customer;
+	double amount;
+	char* currency;
+	int paid;
+} bench_order;
+
+static const lept_field bench_customer_fields[] = {
+	{ "name", offsetof(bench_order, customer.name) - offsetof(bench_order, customer), LEPT_STRING, NULL },
+	{ "email", offsetof(bench_order, customer.email) - offsetof(bench_order, customer), LEPT_STRING, NULL },
+	{ NULL, 0, LEPT_NULL, NULL }
+};
+
+static const lept_field bench_order_fields[] = {
+	{ "order_id", offsetof(bench_order, order_id), LEPT_STRING, NULL },
+	{ "customer", offsetof(bench_order, customer), LEPT_OBJECT, bench_customer_fields },
+	{ "amount", offsetof(bench_order, amount), LEPT_NUMBER, NULL },
+	{ "currency", offsetof(bench_order, currency), LEPT_STRING, NULL },
+	{ "paid", offsetof(bench_order, paid), LEPT_TRUE, NULL },
+	{ NULL, 0, LEPT_NULL, NULL }
+};
+
+static char* bench_strdup(const lept_value* v) {
+	size_t len = lept_get_string_length(v);
+	char* s = (char*)malloc(len + 1);
+	memcpy(s, lept_get_string(v), len + 1);
+	return s;
+}
+
+// һȵϢֻҪмֶΣlinesmetaҪ
+static void bench_into() {
+	const int loops = 200000;
+	const char* json = "{\"order_id\":\"ORD-20240001\",\"customer\":{\"name\":\"alice\",\"email\":\"alice@example.com\",\"tier\":\"gold\"},"
+		"\"amount\":129.99,\"currency\":\"USD\",\"paid\":true,\"lines\":[{\"sku\":\"SKU-00001\",\"qty\":2,\"price\":19.99},"
+		"{\"sku\":\"SKU-00002\",\"qty\":1,\"price\":90.01}],\"meta\":{\"source\":\"web\",\"ip\":\"10.0.0.1\",\"retries\":0}}";
+	size_t len = strlen(json);
+	bench_order o;
+	lept_value v, *c;
+	double t0, t1, t2, s1 = 0, s2 = 0;
+	int i;
+	t0 = bench_now();
+	for (i = 0; i < loops; i++) {
+		memset(&o, 0, sizeof(o));
+		lept_parse_n(&v, json, len);
+		o.order_id = bench_strdup(lept_find_object_value(&v, "order_id", 8));
+		c = lept_find_object_value(&v, "customer", 8);
+		o.customer.name = bench_strdup(lept_find_object_value(c, "name", 4));
+		o.customer.email = bench_strdup(lept_find_object_value(c, "email", 5));
+		o.amount = lept_get_number(lept_find_object_value(&v, "amount", 6));
+		o.currency = bench_strdup(lept_find_object_value(&v, "currency", 8));
+		o.paid = lept_get_boolean(lept_find_object_value(&v, "paid", 4));
+		lept_free(&v);
+		s1 += o.amount + o.paid;
+		lept_free_into(&o, bench_order_fields);
+	}
+	t1 = bench_now();
+	for (i = 0; i < loops; i++) {
+		memset(&o, 0, sizeof(o));
+		lept_parse_into(&o, bench_order_fields, json, len);
+		s2 += o.amount + o.paid;
+		lept_free_into(&o, bench_order_fields);
+	}
+	t2 = bench_now();
+	if (s1 != s2)
+		printf("  wrong result\n");
+	printf("into: %d messages, %d bytes each, 6 of the fields wanted\n", loops, (int)len);
+	printf("  lept_parse_n + extract : %8.3f s, %.1f MB/s\n", t1 - t0, len * (double)loops / (t1 - t0) / (1024 * 1024));
+	printf("  lept_parse_into        : %8.3f s, %.1f MB/s\n", t2 - t1, len * (double)loops / (t2 - t1) / (1024 * 1024));
+}
+
+static int bench_ndjson_record(void* user, size_t offset, int ret, lept_value* v) {
+	(void)user; (void)offset; (void)v;
+	return ret == LEPT_PARSE_OK;
+}
+
+// ÿһС壬߳1CPUܸܲ߳
+static void bench_ndjson() {
+	const int records = 200000;
+	bench_buffer b = { NULL, 0, 0 };
+	char* line;
+	double t;
+	int i, threads, ordered;
+	for (i = 0; i < records; i++) {
+		line = bench_make_request(i % 4 + 1);
+		bench_append(&b, line);
+		bench_append(&b, "\n");
+		free(line);
+	}
+	printf("ndjson: %d records, %.1f MB\n", records, b.len / (1024.0 * 1024));
+	for (ordered = 1; ordered >= 0; ordered--)
+		for (threads = 1; threads <= 16; threads *= 2) {
+			t = bench_wall();
+			if (lept_parse_ndjson(b.s, b.len, threads, ordered, bench_ndjson_record, NULL) != LEPT_PARSE_OK)
+				printf("  error\n");
+			t = bench_wall() - t;
+			printf("  %-9s %2d threads %7.1f MB/s\n", ordered ? "ordered" : "unordered", threads, b.len / t / (1024 * 1024));
+		}
+	free(b.s);
+}
+
+// origin.txtGlossEntryһӣ󲿷ǳıַСҪת
+static void bench_stringify() {
+	const int records = 50000, loops = 20;
+	bench_buffer b = { NULL, 0, 0 };
+	char item[1024];
+	char* out;
+	size_t len = 0;
+	lept_value v;
+	double t;
+	int i;
+	bench_append(&b, "[");
+	for (i = 0; i < records; i++) {
+		sprintf(item, "%s{\"ID\":\"SGML%d\",\"SortAs\":\"SGML\",\"GlossTerm\":\"Standard Generalized Markup Language\","
+			"\"Acronym\":\"SGML\",\"Abbrev\":\"ISO 8879:1986\",\"GlossDef\":{\"para\":\"A meta-markup language, used to create "
+			"markup languages such as DocBook.%s Entry %d of the glossary, see also the \\\"GML\\\" and \\\"XML\\\" entries.\","
+			"\"GlossSeeAlso\":[\"GML\",\"XML\"]},\"GlossSee\":\"markup\"}",
+			i ? "," : "", i, i % 8 ? "" : "\\n\\tRevised", i);
+		bench_append(&b, item);
+	}
+	bench_append(&b, "]");
+	lept_parse_n(&v, b.s, b.len);
+	free(b.s);
+	t = bench_now();
+	for (i = 0; i < loops; i++) {
+		lept_stringify(&v, &out, &len);
+		free(out);
+	}
+	t = bench_now() - t;
+	printf("stringify: %d records, %d bytes of output\n", records, (int)len);
+	printf("  lept_stringify               : %8.3f s, %.1f MB/s\n", t, len * (double)loops / t / (1024 * 1024));
+	lept_free(&v);
+}
+
+// ̵ڴֵλKBLinuxϿclear_refs¼ƣƽ̵̨ķֵ
+static void bench_reset_peak_rss() {
+#if defined(__linux__)
+	FILE* fp = fopen("/proc/self/clear_refs", "w");
+	if (fp) {
+		fputs("5", fp);
+		fclose(fp);
+	}
+#endif
+}
+
+static long bench_peak_rss() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS pmc;
+	return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? (long)(pmc.PeakWorkingSetSize / 1024) : 0;
+#elif defined(__linux__)
+	char line[256];
+	long kb = 0;
+	FILE* fp = fopen("/proc/self/status", "r");
+	if (!fp)
+		return 0;
+	while (fgets(line, sizeof(line), fp))
+		if (strncmp(line, "VmHWM:", 6) == 0)
+			kb = atol(line + 6);
+	fclose(fp);
+	return kb;
+#else
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+#if defined(__APPLE__)
+	return ru.ru_maxrss / 1024; // macOSֽ
+#else
+	return ru.ru_maxrss;
+#endif
+#endif
+}
+
+static size_t bench_count_values(const lept_value* v) {
+	size_t i, n = 1;
+	if (lept_get_type(v) == LEPT_ARRAY)
+		for (i = 0; i < lept_get_array_size(v); i++)
+			n += bench_count_values(lept_get_array_element(v, i));
+	else if (lept_get_type(v) == LEPT_OBJECT)
+		for (i = 0; i < lept_get_object_size(v); i++)
+			n += bench_count_values(lept_get_object_value(v, i));
+	return n;
+}
+
+// 򵥵ͬ࣬ÿɵ϶һ
+static unsigned bench_rand(unsigned* seed) {
+	*seed = *seed * 1103515245u + 12345u;
+	return (*seed >> 16) & 0x7FFF;
+}
+
+// canada.jsonһһΣٸÿʮλЧֵĸ
+static char* bench_make_canada(int rings, int points) {
+	bench_buffer b = { NULL, 0, 0 };
+	char item[128];
+	unsigned seed = 1;
+	int i, j;
+	bench_append(&b, "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},"
+		"\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[");
+	for (i = 0; i < rings; i++) {
+		bench_append(&b, i ? ",[" : "[");
+		for (j = 0; j < points; j++) {
+			sprintf(item, "%s[%.15f,%.15f]", j ? "," : "",
+				-141.0 + bench_rand(&seed) / 32768.0 * 88 + bench_rand(&seed) / 1e9,
+				41.0 + bench_rand(&seed) / 32768.0 * 42 + bench_rand(&seed) / 1e9);
+			bench_append(&b, item);
+		}
+		bench_append(&b, "]");
+	}
+	bench_append(&b, "]}}]}");
+	return b.s;
+}
+
+// twitter.jsonһһ״̬̲һıUTF-8Ķַֽ\\uתǶ׵ûϢ
+static char* bench_make_twitter(int statuses) {
+	static const char* texts[] = {
+		"RT @aym0566x: \xe5\x90\x8d\xe5\x89\x8d:\xe5\x89\x8d\xe7\x94\xb0\xe3\x81\x82\xe3\x82\x86\xe3\x81\xbf \xe7\xac\xac\xe4\xb8\x80\xe5\x8d\xb0\xe8\xb1\xa1:\xe3\x81\xaa\xe3\x82\x93\xe3\x81\x8b\\n\xe6\x80\x96\xe3\x81\x84\xe3\x81\xa3\xef\xbc\x81",
+		"@longhairxMIURA \xe6\x9c\x9d\xe4\xb8\x80\xe3\x83\xa9\xe3\x82\xa4\xe3\x83\x96\xe3\x81\x8a\xe3\x81\xa4\xe3\x81\x8b\xe3\x82\x8c\xe3\x81\x95\xe3\x81\xbe\xe3\x81\xa7\xe3\x81\x97\xe3\x81\x9f\xef\xbd\x9e\xef\xbc\x81",
+		"Caf\\u00e9 opening tonight \\u2014 \\\"everyone\\\" welcome! http:\\/\\/t.co\\/xyzABC123",
+		"short"
+	};
+	bench_buffer b = { NULL, 0, 0 };
+	char item[2048];
+	int i;
+	bench_append(&b, "{\"statuses\":[");
+	for (i = 0; i < statuses; i++) {
+		sprintf(item, "%s{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"ja\"},"
+			"\"created_at\":\"Sun Aug 31 00:29:15 +0000 2014\",\"id\":5058749240958%05d,\"id_str\":\"5058749240958%05d\","
+			"\"text\":\"%s\",\"source\":\"<a href=\\\"http:\\/\\/twitter.com\\/download\\/iphone\\\" rel=\\\"nofollow\\\">Twitter for iPhone<\\/a>\","
+			"\"truncated\":false,\"in_reply_to_status_id\":null,\"user\":{\"id\":%d,\"name\":\"user %d\",\"screen_name\":\"u%d\","
+			"\"location\":\"\xe6\x9d\xb1\xe4\xba\xac\",\"description\":\"%s\",\"followers_count\":%d,\"friends_count\":%d,\"verified\":false},"
+			"\"entities\":{\"hashtags\":[{\"text\":\"tag%d\",\"indices\":[%d,%d]}],\"urls\":[],\"user_mentions\":[]},"
+			"\"retweet_count\":%d,\"favorited\":false,\"retweeted\":false,\"lang\":\"ja\"}",
+			i ? "," : "", i, i, texts[i % 4], 1186275104 + i, i, i, texts[(i + 1) % 4], i * 7 % 5000, i * 3 % 800,
+			i % 100, i % 50, i % 50 + 6, i % 13);
+		bench_append(&b, item);
+	}
+	bench_append(&b, "]}");
+	return b.s;
+}
+
+// ͶǶ׵úظܶ
+static char* bench_make_deep(int docs, int depth) {
+	bench_buffer b = { NULL, 0, 0 };
+	int i, j;
+	bench_append(&b, "[");
+	for (i = 0; i < docs; i++) {
+		bench_append(&b, i ? "," : "");
+		for (j = 0; j < depth; j++)
+			bench_append(&b, j & 1 ? "[" : "{\"a\":");
+		bench_append(&b, "1");
+		for (j = depth - 1; j >= 0; j--)
+			bench_append(&b, j & 1 ? "]" : "}");
+	}
+	bench_append(&b, "]");
+	return b.s;
+}
+
+// һзǳļ
+static char* bench_make_wide(int keys) {
+	bench_buffer b = { NULL, 0, 0 };
+	char item[128];
+	int i;
+	bench_append(&b, "{");
+	for (i = 0; i < keys; i++) {
+		if (i % 3 == 0)
+			sprintf(item, "%s\"field_%06d\":%d", i ? "," : "", i, i);
+		else if (i % 3 == 1)
+			sprintf(item, "%s\"field_%06d\":\"value %d\"", i ? "," : "", i, i);
+		else
+			sprintf(item, "%s\"field_%06d\":%s", i ? "," : "", i, i & 4 ? "true" : "null");
+		bench_append(&b, item);
+	}
+	bench_append(&b, "}");
+	return b.s;
+}
+
+// ֻ˶ٴΣallocresize
+static void* bench_count_alloc(void* user, size_t size) {
+	++*(size_t*)user;
+	return malloc(size);
+}
+
+static void* bench_count_resize(void* user, void* p, size_t size) {
+	++*(size_t*)user;
+	return realloc(p, size);
+}
+
+static void bench_count_release(void* user, void* p) {
+	(void)user;
+	free(p);
+}
+
+#ifdef LEPT_STATS
+// ٽһ飬ʱ䶼
+static void bench_corpus_stats(const char* json, size_t len) {
+	lept_stats s;
+	lept_value v;
+	char* out;
+	size_t n;
+	lept_stats_reset();
+	lept_parse_n(&v, json, len);
+	lept_stringify(&v, &out, &n);
+	free(out);
+	lept_free(&v);
+	lept_stats_get(&s);
+	printf("           %d strings, %d numbers, %d arrays, %d objects, depth %d; %d mallocs (%d KB), %d reallocs, stack peak %d KB\n",
+		(int)s.values[LEPT_STRING], (int)s.values[LEPT_NUMBER], (int)s.values[LEPT_ARRAY], (int)s.values[LEPT_OBJECT], (int)s.max_depth,
+		(int)s.mallocs, (int)(s.malloc_bytes / 1024), (int)s.reallocs, (int)(s.stack_peak / 1024));
+	if (s.cycles[LEPT_PHASE_PARSE])
+		printf("           cycles: parse %.0fM (strings %.0f%%, numbers %.0f%%), stringify %.0fM\n", s.cycles[LEPT_PHASE_PARSE] / 1e6,
+			100.0 * s.cycles[LEPT_PHASE_STRING] / s.cycles[LEPT_PHASE_PARSE], 100.0 * s.cycles[LEPT_PHASE_NUMBER] / s.cycles[LEPT_PHASE_PARSE],
+			s.cycles[LEPT_PHASE_STRINGIFY] / 1e6);
+}
+#endif
+
+// ÿϷֱparsestringifyٶȡƽÿֵĽʱ䡢mallocڴֵ
+static void bench_corpus_run(const char* name, char* json, int loops) {
+	size_t len = strlen(json), n, values, allocs = 0;
+	lept_allocator a = { bench_count_alloc, bench_count_resize, bench_count_release, NULL };
+	double tp = 0, ts = 0, t;
+	lept_value v;
+	char* out;
+	long rss;
+	int k, ret;
+	bench_reset_peak_rss();
+	for (k = 0; k < loops; k++) {
+		t = bench_now();
+		ret = lept_parse_n(&v, json, len);
+		tp += bench_now() - t;
+		if (ret != LEPT_PARSE_OK) {
+			printf("  %-8s parse error %d\n", name, ret);
+			free(json);
+			return;
+		}
+		t = bench_now();
+		lept_stringify(&v, &out, &n);
+		ts += bench_now() - t;
+		free(out);
+		if (k + 1 < loops)
+			lept_free(&v);
+	}
+	values = bench_count_values(&v);
+	rss = bench_peak_rss();
+	lept_free(&v);
+	// һõķʱջ
+	a.user = &allocs;
+	lept_parse_with(&v, json, len, &a);
+	lept_free_with(&v, &a);
+	printf("  %-8s %10d %9d %9.1f %9.1f %8.1f %9d %9ld\n", name, (int)len, (int)values,
+		len * (double)loops / tp / (1024 * 1024), len * (double)loops / ts / (1024 * 1024),
+		tp / loops / values * 1e9, (int)allocs, rss);
+#ifdef LEPT_STATS
+	bench_corpus_stats(json, len);
+#endif
+	free(json);
+}
+
+static void bench_corpus() {
+	printf("corpus:\n  %-8s %10s %9s %9s %9s %8s %9s %9s\n", "", "bytes", "values", "parse", "stringify", "ns/value", "allocs", "peak KB");
+	printf("  %-8s %10s %9s %9s %9s %8s %9s %9s\n", "", "", "", "MB/s", "MB/s", "", "", "");
+	bench_corpus_run("canada", bench_make_canada(480, 1000), 10);
+	bench_corpus_run("twitter", bench_make_twitter(5000), 10);
+	bench_corpus_run("deep", bench_make_deep(2000, 1000), 10);
+	bench_corpus_run("wide", bench_make_wide(200000), 10);
+}
+
+// һԪһԪصعͶ󣬺ǰֻԼܺԪٽlept_valueƴıٽ
+static void bench_build() {
+	const int n = 100000, loops = 50;
+	bench_buffer b = { NULL, 0, 0 };
+	lept_value v, *e;
+	char key[32], (*keys)[16] = (char(*)[16])malloc(n * 16);
+	double t;
+	int i, j;
+
+	printf("build: %d elements\n", n);
+	for (i = 0; i < n; i++)
+		sprintf(keys[i], "key%d", i);
+	t = bench_now();
+	for (j = 0; j < loops; j++) {
+		lept_init(&v);
+		lept_set_array(&v, 0);
+		for (i = 0; i < n; i++)
+			lept_set_number(lept_pushback_array_element(&v), i);
+		lept_free(&v);
+	}
+	printf("  lept_pushback_array_element  : %8.3f s\n", bench_now() - t);
+
+	t = bench_now();
+	for (j = 0; j < loops; j++) {
+		lept_init(&v);
+		lept_set_array(&v, n);
+		for (i = 0; i < n; i++)
+			lept_set_number(lept_pushback_array_element(&v), i);
+		lept_free(&v);
+	}
+	printf("  lept_set_array(n) + pushback : %8.3f s\n", bench_now() - t);
+
+	// ǰԼջԪأƵôСһڴ
+	t = bench_now();
+	for (j = 0; j < loops; j++) {
+		size_t size = 0, capacity = 0;
+		lept_value* stack = NULL;
+		for (i = 0; i < n; i++) {
+			if (size == capacity)
+				stack = (lept_value*)realloc(stack, (capacity += capacity / 2 + 4) * sizeof(lept_value));
+			lept_init(&stack[size]);
+			lept_set_number(&stack[size++], i);
+		}
+		lept_init(&v);
+		v.type = LEPT_ARRAY;
+		v.u.a.size = size;
+		memcpy(v.u.a.e = (lept_value*)malloc(size * sizeof(lept_value)), stack, size * sizeof(lept_value));
+		free(stack);
+		lept_free(&v);
+	}
+	printf("  own stack + copy             : %8.3f s\n", bench_now() - t);
+
+	t = bench_now();
+	for (j = 0; j < loops / 5; j++) {
+		lept_init(&v);
+		lept_set_object(&v, 0);
+		for (i = 0; i < n; i++)
+			lept_set_number(lept_set_object_value(&v, keys[i], strlen(keys[i])), i);
+		lept_free(&v);
+	}
+	printf("  lept_set_object_value        : %8.3f s\n", (bench_now() - t) * 5);
+
+	t = bench_now();
+	for (j = 0; j < loops / 5; j++) {
+		lept_init(&v);
+		lept_set_object(&v, n);
+		for (i = 0; i < n; i++)
+			lept_set_number(lept_set_object_value(&v, keys[i], strlen(keys[i])), i);
+		lept_free(&v);
+	}
+	printf("  lept_set_object(n) + set     : %8.3f s\n", (bench_now() - t) * 5);
+
+	bench_append(&b, "{");
+	for (i = 0; i < n; i++) {
+		sprintf(key, "%s\"key%d\":%d", i ? "," : "", i, i);
+		bench_append(&b, key);
+	}
+	bench_append(&b, "}");
+	t = bench_now();
+	for (j = 0; j < loops / 5; j++) {
+		lept_init(&v);
+		lept_parse_n(&v, b.s, b.len);
+		e = lept_find_object_value(&v, "key7", 4);
+		(void)e;
+		lept_free(&v);
+	}
+	printf("  object text + lept_parse_n   : %8.3f s\n", (bench_now() - t) * 5);
+	free(b.s);
+	free(keys);
+}
+
+typedef struct {
+	const char* name;
+	void(*run)();
+} bench_case;
+
+static const bench_case bench_cases[] = {
+	{ "arena", bench_arena },
+	{ "scan", bench_scan },
+	{ "number", bench_number },
+	{ "dtoa", bench_dtoa },
+	{ "find", bench_find },
+	{ "sax", bench_sax },
+	{ "feed", bench_feed },
+	{ "file", bench_file },
+	{ "sink", bench_sink },
+	{ "nest", bench_nest },
+	{ "reuse", bench_reuse },
+	{ "ndjson", bench_ndjson },
+	{ "structural", bench_structural },
+	{ "lazy", bench_lazy },
+	{ "tape", bench_tape },
+	{ "short", bench_short },
+	{ "intern", bench_intern },
+	{ "into", bench_into },
+	{ "stringify", bench_stringify },
+	{ "corpus", bench_corpus },
+	{ "build", bench_build },
+};
+
+int main(int argc, char* argv[]) {
+	size_t i;
+	for (i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++)
+		if (argc < 2 || strcmp(argv[1], bench_cases[i].name) == 0)
+			bench_cases[i].run();
+	return 0;
+}
@@ -4,8 +4,39 @@
 #include <errno.h>
 #include <math.h>    /* HUGE_VAL */
 #include <stdio.h>
+#include <string.h>  /* memcpy */
+#include <stdint.h>  /* uintptr_t, uint64_t */
+#include <float.h>   /* FLT_EVAL_METHOD */
+
+// ûжLEPT_NO_SIMDʱx86SSE2/AVX2հ׺ɨַ
+#if !defined(LEPT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define LEPT_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER) || defined(__GNUC__)
+#define LEPT_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+// lept_parse_fileӳļlept_parse_ndjson߳
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if !defined(LEPT_NO_THREADS)
+#include <pthread.h>
+#endif
+#endif
+#include "leptjson_pow.h"
 
 #define EXPECT(c, ch)       do { assert(*c->json == (ch)); c->json++; } while(0)
+#define PEEK(c)             ((c)->json != (c)->end ? *(c)->json : '\0') // ˽β͵'\0'
 #define ISDIGIT(ch)         ((ch) >= '0' && (ch) <= '9')
 #define ISDIGIT1TO9(ch)     ((ch) >= '1' && (ch) <= '9')
 #define escape (%x5C)
@@ -18,10 +49,134 @@
 #define LEPT_PARSE_STRINGIFY_INIT_SIZE 256
 #endif
 
+// ɵʱַôֽһת壬ÿԤ6Ŀռ
+#ifndef LEPT_STRINGIFY_SEGMENT_SIZE
+#define LEPT_STRINGIFY_SEGMENT_SIZE 4096
+#endif
+
+// lept_stringify_sinkĬÿĴС
+#ifndef LEPT_STRINGIFY_FLUSH_SIZE
+#define LEPT_STRINGIFY_FLUSH_SIZE 65536
+#endif
+
+// ԱֵĶ󣬽ʱ˳㽨Ĺϣ
+#ifndef LEPT_OBJECT_INDEX_MIN
+#define LEPT_OBJECT_INDEX_MIN 16
+#endif
+
+///!*********************ͳ*******************
+// LEPT_STATSûжʱĺ궼ǿյ
+#if defined(LEPT_STATS)
+#if defined(_MSC_VER)
+#define LEPT_THREAD_LOCAL __declspec(thread)
+#elif defined(LEPT_NO_THREADS)
+#define LEPT_THREAD_LOCAL
+#else
+#define LEPT_THREAD_LOCAL __thread
+#endif
+
+static LEPT_THREAD_LOCAL lept_stats lept_stats_local;
+#define LEPT_STAT_ADD(field, n) (lept_stats_local.field += (n))
+#define LEPT_STAT_MAX(field, n) do { if ((n) > lept_stats_local.field) lept_stats_local.field = (n); } while(0)
+
+void lept_stats_reset() {
+	memset(&lept_stats_local, 0, sizeof(lept_stats_local));
+}
+
+void lept_stats_get(lept_stats* s) {
+	assert(s != NULL);
+	*s = lept_stats_local;
+}
+
+// fromӵǰ߳ϣֵȡ
+static void lept_stats_merge(const lept_stats* from) {
+	lept_stats* to = &lept_stats_local;
+	int i;
+	to->bytes += from->bytes;
+	to->output_bytes += from->output_bytes;
+	for (i = 0; i <= LEPT_OBJECT; i++)
+		to->values[i] += from->values[i];
+	to->mallocs += from->mallocs;
+	to->malloc_bytes += from->malloc_bytes;
+	to->reallocs += from->reallocs;
+	to->realloc_bytes += from->realloc_bytes;
+	LEPT_STAT_MAX(stack_peak, from->stack_peak);
+	LEPT_STAT_MAX(max_depth, from->max_depth);
+	for (i = 0; i < LEPT_PHASE_COUNT; i++)
+		to->cycles[i] += from->cycles[i];
+}
+#else
+#define LEPT_STAT_ADD(field, n) ((void)sizeof(n)) // ֵֻֻΪͳƶеıûõ
+#define LEPT_STAT_MAX(field, n) ((void)sizeof(n))
+#endif
+
+// ÿ׶ڿʼͽʱһμͬһ׶βǶ
+#if defined(LEPT_STATS) && defined(LEPT_STATS_CYCLES)
+#include <time.h>
+static LEPT_THREAD_LOCAL uint64_t lept_stats_start[LEPT_PHASE_COUNT];
+
+static uint64_t lept_cycles() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	return __rdtsc();
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_ia32_rdtsc();
+#else
+	return (uint64_t)clock();
+#endif
+}
+#define LEPT_STAT_START(phase) (lept_stats_start[phase] = lept_cycles())
+#define LEPT_STAT_STOP(phase)  (lept_stats_local.cycles[phase] += lept_cycles() - lept_stats_start[phase])
+#else
+#define LEPT_STAT_START(phase) ((void)0)
+#define LEPT_STAT_STOP(phase)  ((void)0)
+#endif
+
+///!*********************ڴ*******************
+static void* lept_std_alloc(void* user, size_t size) {
+	(void)user;
+	return malloc(size);
+}
+
+static void* lept_std_resize(void* user, void* p, size_t size) {
+	(void)user;
+	return realloc(p, size);
+}
+
+static void lept_std_release(void* user, void* p) {
+	(void)user;
+	free(p);
+}
+
+static lept_allocator lept_allocator_global = { lept_std_alloc, lept_std_resize, lept_std_release, NULL };
+
+void lept_set_allocator(const lept_allocator* a) {
+	static const lept_allocator std = { lept_std_alloc, lept_std_resize, lept_std_release, NULL };
+	assert(a == NULL || (a->alloc != NULL && a->resize != NULL && a->release != NULL));
+	lept_allocator_global = a ? *a : std;
+}
+
+// ﲻֱӵmalloc/realloc/free⼸alept_allocator*
+// LEPT_REALLOCpΪNULLʱ൱LEPT_MALLOCLEPT_FREEpΪNULLʱʲôͱ׼һ
+#define LEPT_GLOBAL              (&lept_allocator_global)
+#define LEPT_MALLOC(a, size)     ((a)->alloc((a)->user, (size)))
+#define LEPT_REALLOC(a, p, size) ((p) ? (a)->resize((a)->user, (p), (size)) : (a)->alloc((a)->user, (size)))
+#define LEPT_FREE(a, p)          do { if (p) (a)->release((a)->user, (p)); } while(0)
+
 typedef struct {
 	const char* json;
+	const char* end;   // Ľβ'\0'jsonм'\0'ֻͨķǷַ
 	char* stack;
 	size_t size, top; // sizeǰջtopջλ
+	size_t peak;       // topλãûʱҪҪ
+	lept_arena* arena; // ΪNULLʱ򣬽ڴ涼arenaз
+	lept_intern* intern; // ΪNULLʱ򣬳ȡ
+	int insitu;        // ԭؽֱַӽ뵽jsonʱjsonʵǿд
+	size_t max_depth;  // ͶǶ׵Ĳ
+	size_t depth;      // SAXǰǶ׵Ĳ
+	lept_write_func write; // ɵʱΪNULLͱɱ߽ջֻ
+	void* user;
+	size_t chunk;      // ÿνwriteֽ
+	const lept_allocator* alloc; // ʱջͽ䣬Ĭȫֵ
 } lept_context;
 
 // ջĲ൱C++ vector
@@ -33,10 +188,15 @@ static void* lept_context_push(lept_context* c, size_t size) { // 
 			c->size = LEPT_PARSE_STACK_INIT_SIZE;
 		while (c->top + size >= c->size)
 			c->size += c->size >> 1;  /* c->size * 1.5 */
-		c->stack = (char*)realloc(c->stack, c->size);
+		c->stack = (char*)LEPT_REALLOC(c->alloc, c->stack, c->size);
+		LEPT_STAT_ADD(reallocs, 1);
+		LEPT_STAT_ADD(realloc_bytes, c->size);
 	}
 	ret = c->stack + c->top;
 	c->top += size;
+	if (c->top > c->peak)
+		c->peak = c->top;
+	LEPT_STAT_MAX(stack_peak, c->top);
 	return ret;
 }
 
@@ -48,26 +208,291 @@ static void* lept_context_pop(lept_context* c, size_t size) { // 
 // һջcмһַ
 #define PUTC(c, ch) do { *(char*)lept_context_push(c, sizeof(char)) = (ch); } while(0)
 
+// Ҫ[json, json + len)ĶĬֵջǿյ
+static void lept_context_init(lept_context* c, const char* json, size_t len) {
+	c->json = json;
+	c->end = len ? json + len : json;
+	c->stack = NULL;
+	c->size = c->top = c->peak = 0;
+	c->arena = NULL;
+	c->intern = NULL;
+	c->insitu = 0;
+	c->max_depth = LEPT_PARSE_MAX_DEPTH;
+	c->depth = 0;
+	c->write = NULL;
+	c->user = NULL;
+	c->chunk = 0;
+	c->alloc = LEPT_GLOBAL;
+}
+
+// õĻÿLEPT_SCRATCH_WINDOWμһΣʱõ󳤶peak
+// һpeakżһĵڴһֱռ
+static void lept_scratch_shrink(char** stack, size_t* size, size_t* peak, unsigned* uses) {
+	if (++*uses < LEPT_SCRATCH_WINDOW)
+		return;
+	if (*peak == 0) {
+		LEPT_FREE(LEPT_GLOBAL, *stack);
+		*stack = NULL;
+		*size = 0;
+	}
+	else if (*peak < *size / 2) {
+		*size = *peak + 1; // pushҪtopʼСsize
+		*stack = (char*)LEPT_REALLOC(LEPT_GLOBAL, *stack, *size);
+	}
+	*peak = 0;
+	*uses = 0;
+}
+
+///!*********************arena*******************
+// ͷſõڴ棬usedѾгȥֽ
+struct lept_arena_block {
+	lept_arena_block* next;
+	size_t size, used;
+};
 
-// ͷſռ䣬objͣҪݹͷſռ
-void lept_free(lept_value* v) {
+// гȥڴ涼룬֤lept_value/lept_memberdoubleָ
+#define LEPT_ARENA_ALIGN 8
+#define LEPT_ARENA_ROUND(n) (((n) + (LEPT_ARENA_ALIGN - 1)) & ~(size_t)(LEPT_ARENA_ALIGN - 1))
+#define LEPT_ARENA_HEADER LEPT_ARENA_ROUND(sizeof(lept_arena_block))
+
+void lept_arena_init(lept_arena* a) {
+	assert(a != NULL);
+	a->head = NULL;
+	a->block_size = LEPT_ARENA_BLOCK_SIZE;
+	a->blocks = 0;
+}
+
+void* lept_arena_alloc(lept_arena* a, size_t size) {
+	lept_arena_block* b;
+	assert(a != NULL);
+	b = a->head;
+	size = LEPT_ARENA_ROUND(size);
+	if (b == NULL || b->size - b->used < size) {
+		// ǰŲˣ¿һ飬ĴСһĵֻҪٵļ
+		size_t n = a->block_size;
+		while (n < size)
+			n <<= 1;
+		b = (lept_arena_block*)LEPT_MALLOC(LEPT_GLOBAL, LEPT_ARENA_HEADER + n);
+		LEPT_STAT_ADD(mallocs, 1);
+		LEPT_STAT_ADD(malloc_bytes, LEPT_ARENA_HEADER + n);
+		b->size = n;
+		b->used = 0;
+		b->next = a->head;
+		a->head = b;
+		a->block_size = n << 1;
+		a->blocks++;
+	}
+	b->used += size;
+	return (char*)b + LEPT_ARENA_HEADER + b->used - size;
+}
+
+void lept_arena_reset(lept_arena* a) {
+	lept_arena_block* b;
+	assert(a != NULL);
+	if (a->head == NULL)
+		return;
+	// µһģһĵãȶ֮ÿresetO(1)
+	b = a->head->next;
+	while (b != NULL) {
+		lept_arena_block* next = b->next;
+		LEPT_FREE(LEPT_GLOBAL, b);
+		b = next;
+	}
+	a->head->next = NULL;
+	a->head->used = 0;
+	a->blocks = 1;
+}
+
+void lept_arena_free(lept_arena* a) {
+	lept_arena_reset(a);
+	LEPT_FREE(LEPT_GLOBAL, a->head);
+	lept_arena_init(a);
+}
+
+// ڴ䣬arenaģʽ´arenaУmalloc
+static void* lept_context_alloc(lept_context* c, size_t size) {
+	if (c->arena)
+		return lept_arena_alloc(c->arena, size);
+	LEPT_STAT_ADD(mallocs, 1);
+	LEPT_STAT_ADD(malloc_bytes, size);
+	return LEPT_MALLOC(c->alloc, size);
+}
+
+
+// [src, src + len)ƵdstdstҪֵģմʱsrcNULLܽmemcpy
+#define LEPT_COPY(dst, src, len) do { char* lept_dst_ = (dst); if (len) memcpy(lept_dst_, src, len); } while(0)
+
+// Ϊlenֵַ'\0'ѾдˣõֻҪд
+// ֱַӷvĴc䣬cΪNULLʱȫֵķ
+static char* lept_string_buffer(lept_context* c, lept_value* v, size_t len) {
+	v->type = LEPT_STRING;
+	if (len <= LEPT_SHORT_STRING_MAX) {
+		v->flags |= LEPT_FLAG_SHORT;
+		v->u.ss[LEPT_SHORT_STRING_MAX] = (char)(LEPT_SHORT_STRING_MAX - len);
+		v->u.ss[len] = '\0';
+		return v->u.ss;
+	}
+	v->u.s.s = c ? (char*)lept_context_alloc(c, len + 1) : (char*)LEPT_MALLOC(LEPT_GLOBAL, len + 1);
+	v->u.s.s[len] = '\0';
+	v->u.s.len = len;
+	return v->u.s.s;
+}
+
+// Ҳһ̵ļm
+static char* lept_key_buffer(lept_context* c, lept_member* m, size_t klen) {
+	char* k = m->k.s;
+	if (klen > LEPT_SHORT_KEY_MAX)
+		k = m->k.p = c ? (char*)lept_context_alloc(c, klen + 1) : (char*)LEPT_MALLOC(LEPT_GLOBAL, klen + 1);
+	k[klen] = '\0';
+	m->klen = klen;
+	return k;
+}
+
+#define LEPT_STR(v)      ((v)->flags & LEPT_FLAG_SHORT ? (v)->u.ss : (v)->u.s.s)
+#define LEPT_STR_LEN(v)  ((v)->flags & LEPT_FLAG_SHORT ? (size_t)(LEPT_SHORT_STRING_MAX - (v)->u.ss[LEPT_SHORT_STRING_MAX]) : (v)->u.s.len)
+#define LEPT_KEY(m)      ((m)->klen <= LEPT_SHORT_KEY_MAX ? (m)->k.s : (m)->k.p)
+
+// פÿݼǰϢ
+typedef struct {
+	size_t refs;        // Ҳһ
+	size_t len;
+	uint32_t hash;      // lept_hash_keyĽĹϣʱ
+} lept_intern_entry;
+
+#define LEPT_INTERN_ENTRY(k) ((lept_intern_entry*)((char*)(k) - sizeof(lept_intern_entry)))
+
+static void lept_intern_release(char* k) {
+	lept_intern_entry* e = LEPT_INTERN_ENTRY(k);
+	if (--e->refs == 0)
+		LEPT_FREE(LEPT_GLOBAL, e);
+}
+
+// ͷųԱļflagsڶı־aǷķ
+static void lept_key_free(lept_member* m, int flags, const lept_allocator* a) {
+	if (m->klen <= LEPT_SHORT_KEY_MAX || (flags & LEPT_FLAG_BORROWED))
+		return;
+	if (flags & LEPT_FLAG_INTERNED)
+		lept_intern_release(m->k.p);
+	else
+		LEPT_FREE(a, m->k.p);
+}
+
+// һõʽջÿһһ/һҪԪ
+// ʱþֲ飬˲malloc
+#define LEPT_WALK_LOCAL 32
+typedef struct {
+	const lept_value* v;
+	size_t i;
+} lept_walk_entry;
+
+typedef struct {
+	lept_walk_entry local[LEPT_WALK_LOCAL];
+	lept_walk_entry* e;
+	size_t top, size;
+	const lept_allocator* alloc;
+} lept_walk;
+
+static void lept_walk_init(lept_walk* w, const lept_allocator* a) {
+	w->alloc = a;
+	w->e = w->local;
+	w->top = 0;
+	w->size = LEPT_WALK_LOCAL;
+}
+
+static void lept_walk_push(lept_walk* w, const lept_value* v) {
+	if (w->top == w->size) {
+		w->size += w->size >> 1;
+		if (w->e == w->local) {
+			w->e = (lept_walk_entry*)LEPT_MALLOC(w->alloc, w->size * sizeof(lept_walk_entry));
+			memcpy(w->e, w->local, sizeof(w->local));
+			LEPT_STAT_ADD(mallocs, 1);
+			LEPT_STAT_ADD(malloc_bytes, w->size * sizeof(lept_walk_entry));
+		}
+		else {
+			w->e = (lept_walk_entry*)LEPT_REALLOC(w->alloc, w->e, w->size * sizeof(lept_walk_entry));
+			LEPT_STAT_ADD(reallocs, 1);
+			LEPT_STAT_ADD(realloc_bytes, w->size * sizeof(lept_walk_entry));
+		}
+	}
+	w->e[w->top].v = v;
+	w->e[w->top].i = 0;
+	w->top++;
+}
+
+static void lept_walk_free(lept_walk* w) {
+	if (w->e != w->local)
+		LEPT_FREE(w->alloc, w->e);
+}
+
+// ޸Ĺ/ԪǰLEPT_FLAG_CAPACITY
+typedef union {
+	size_t capacity;
+	double align; // Ԫdouble֤Ԫض
+} lept_capacity_header;
+
+#define LEPT_CAPACITY_HEADER(e) ((lept_capacity_header*)(e) - 1)
+// ԪڵǿڴĿͷͷŵʱ
+#define LEPT_CONTAINER_BLOCK(v, e) ((v)->flags & LEPT_FLAG_CAPACITY ? (void*)LEPT_CAPACITY_HEADER(e) : (void*)(e))
+
+// ֵڷ֮ǰչlept_parse_lazy
+static void lept_lazy_expand(lept_value* v);
+#define LEPT_EXPAND(v) do { if ((v)->flags & LEPT_FLAG_LAZY) lept_lazy_expand((lept_value*)(v)); } while(0)
+
+// ͷſռ䣬Ͷʽջһһͷţݹ
+// ûչֵָֻ룬ûҪͷŵ
+void lept_free_with(lept_value* v, const lept_allocator* a) {
+	lept_walk w;
 	assert(v != NULL);
-	if (v->type == LEPT_STRING)
-		free(v->u.s.s);
-	else if (v->type == LEPT_ARRAY) {
-		size_t i = 0;
-		for (; i < v->u.a.size; i++) lept_free(v->u.a.e + i);
-		free(v->u.a.e);
-	}
-	else if (v->type == LEPT_OBJECT) {
-		size_t i = 0;
-		for (i = 0; i < v->u.o.size; i++) {
-			free(v->u.o.m[i].k);
-			lept_free(&v->u.o.m[i].v);
+	if (a == NULL)
+		a = LEPT_GLOBAL;
+	if (v->flags & LEPT_FLAG_LAZY)
+		;
+	else if (v->type == LEPT_STRING) {
+		if (!(v->flags & (LEPT_FLAG_BORROWED | LEPT_FLAG_SHORT)))
+			LEPT_FREE(a, v->u.s.s);
+	}
+	else if (v->type == LEPT_ARRAY || v->type == LEPT_OBJECT) {
+		lept_walk_init(&w, a);
+		lept_walk_push(&w, v);
+		while (w.top) {
+			lept_walk_entry* t = &w.e[w.top - 1];
+			lept_value* x = (lept_value*)t->v;
+			lept_value* e = NULL;
+			size_t i = t->i, n = x->type == LEPT_ARRAY ? x->u.a.size : x->u.o.size;
+			// ͷһԪأ/ʱȽһ
+			while (i < n) {
+				if (x->type == LEPT_ARRAY)
+					e = &x->u.a.e[i++];
+				else {
+					lept_key_free(&x->u.o.m[i], x->flags, a);
+					e = &x->u.o.m[i++].v;
+				}
+				if (e->flags & LEPT_FLAG_LAZY)
+					;
+				else if (e->type == LEPT_ARRAY || e->type == LEPT_OBJECT)
+					break;
+				else if (e->type == LEPT_STRING && !(e->flags & (LEPT_FLAG_BORROWED | LEPT_FLAG_SHORT)))
+					LEPT_FREE(a, e->u.s.s);
+				e = NULL;
+			}
+			if (e != NULL) {
+				t->i = i;
+				lept_walk_push(&w, e);
+			}
+			else {
+				// һԪضͷ
+				LEPT_FREE(a, x->type == LEPT_ARRAY ? LEPT_CONTAINER_BLOCK(x, x->u.a.e) : LEPT_CONTAINER_BLOCK(x, x->u.o.m));
+				w.top--;
+			}
 		}
-		free(v->u.o.m);
+		lept_walk_free(&w);
 	}
 	v->type = LEPT_NULL;
+	v->flags = 0;
+}
+
+void lept_free(lept_value* v) {
+	lept_free_with(v, NULL);
 }
 
 ///!*********************ʹһЩúͻȡֵĺ*******************
@@ -75,11 +500,7 @@ void lept_free(lept_value* v) {
 void lept_set_string(lept_value* v, const char* s, size_t len) {
 	assert(v != NULL && (s != NULL || len == 0));
 	lept_free(v);
-	v->u.s.s = (char*)malloc(len + 1);
-	memcpy(v->u.s.s, s, len);
-	v->u.s.s[len] = '\0';
-	v->u.s.len = len;
-	v->type = LEPT_STRING;
+	LEPT_COPY(lept_string_buffer(NULL, v, len), s, len);
 }
 
 int lept_get_boolean(const lept_value* v) {
@@ -112,403 +533,3608 @@ double lept_get_number(const lept_value* v) {
 
 lept_value* lept_get_array_element(const lept_value* v, size_t index) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
 	assert(index < v->u.a.size);
 	return &v->u.a.e[index];
 }
 
 size_t lept_get_array_size(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
 	return v->u.a.size;
 }
 
 const char* lept_get_string(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_STRING);
-	return v->u.s.s;
+	LEPT_EXPAND(v);
+	return LEPT_STR(v);
 }
 size_t lept_get_string_length(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_STRING);
-	return v->u.s.len;
+	LEPT_EXPAND(v);
+	return LEPT_STR_LEN(v);
 }
 
 
 size_t lept_get_object_size(const lept_value* v) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_EXPAND(v);
 	return v->u.o.size;
 }
 
 const char* lept_get_object_key(const lept_value* v, size_t index) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_EXPAND(v);
 	assert(index < v->u.o.size);
-	return v->u.o.m[index].k;
+	return LEPT_KEY(&v->u.o.m[index]);
 }
 
 size_t lept_get_object_key_length(const lept_value* v, size_t index) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_EXPAND(v);
 	assert(index < v->u.o.size);
 	return v->u.o.m[index].klen;
 }
 
 lept_value* lept_get_object_value(const lept_value* v, size_t index) {
 	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_EXPAND(v);
 	assert(index < v->u.o.size);
 	return &v->u.o.m[index].v;
 }
 
-
-///!*************************һЩĺ******************************
-// ַʼ
-
+///!*********************Ĺϣ*******************
 /*
-	https://zhuanlan.zhihu.com/p/22731540?refer=json-tutorial
-	unicodeһ
-	ַ """\u20AC"""
-	ô16ƵĹ޷ֵĴСȻձжΪnַд뵽ֽд
-
+	ѰַĹϣڳԱĺ棬ͳԱͬһη䣬һͷ
+	ǳԱ±+10ʾղۣ۵ǲС22ݣҪⱣ
+	ĶǳԱ޸ĹĶlept_set_object_value
 */
-static const char* lept_parse_hex4(const char* p, unsigned* u) {
-	// pʼĸַŵ޷U
-	int i;
-	*u = 0;
-	for (i = 0; i < 4; i++) {
-		char ch = *p++;
-		*u <<= 4;
-		if (ch >= '0' && ch <= '9')  *u |= ch - '0';
-		else if (ch >= 'A' && ch <= 'F')  *u |= ch - ('A' - 10);
-		else if (ch >= 'a' && ch <= 'f')  *u |= ch - ('a' - 10);
-		else return NULL;
-	}
-	return p;
+static size_t lept_object_index_capacity(size_t size) {
+	size_t cap = 4;
+	while (cap < size * 2)
+		cap <<= 1;
+	return cap;
 }
 
-static void lept_encode_utf8(lept_context* c, unsigned u) {
-	//һunsignedintתΪ׼1-4charݣ0xffΪ˷ֹľ档
-	if (u <= 0x7F)
-		PUTC(c, u & 0xFF);
-	else if (u <= 0x7FF) {
-		PUTC(c, 0xC0 | ((u >> 6) & 0xFF));
-		PUTC(c, 0x80 | (u & 0x3F));
-	}
-	else if (u <= 0xFFFF) {
-		PUTC(c, 0xE0 | ((u >> 12) & 0xFF));
-		PUTC(c, 0x80 | ((u >> 6) & 0x3F));
-		PUTC(c, 0x80 | (u & 0x3F));
-	}
-	else {
-		assert(u <= 0x10FFFF);
-		PUTC(c, 0xF0 | ((u >> 18) & 0xFF));
-		PUTC(c, 0x80 | ((u >> 12) & 0x3F));
-		PUTC(c, 0x80 | ((u >> 6) & 0x3F));
-		PUTC(c, 0x80 | (u & 0x3F));
-	}
+static uint32_t lept_hash_key(const char* k, size_t klen) {
+	uint32_t h = 2166136261u; // FNV-1a
+	size_t i;
+	for (i = 0; i < klen; i++)
+		h = (h ^ (unsigned char)k[i]) * 16777619u;
+	return h;
 }
 
-#define STRING_ERROR(ret) do { c->top = head; return ret; } while(0)
-// ַѽдstrlen
-// strָ c->stack еԪأҪ c->stack
-static int lept_parse_string_raw(lept_context* c, char** str, size_t* plen) {
-	size_t head = c->top, len;
-	const char* p;
-	unsigned u, u2;
-	EXPECT(c, '\"'); //ַӦԡͷ
-	p = c->json;
-	for (;;) {
-		char ch = *p++;
-		switch (ch) {
-		case '\"': // ʾַѾ
-			len = c->top - head;
-			*str = (char*)lept_context_pop(c, len);
-			*plen = len;
-			c->json = p;
-			return LEPT_PARSE_OK;
-		case '\\': // תַ
-			switch (*p++) {
-			case '\"': PUTC(c, '\"'); break;
-			case '\\': PUTC(c, '\\'); break;
-			case '/':  PUTC(c, '/');  break;
-			case 'b':  PUTC(c, '\b'); break;
-			case 'f':  PUTC(c, '\f'); break;
-			case 'n':  PUTC(c, '\n'); break;
-			case 'r':  PUTC(c, '\r'); break;
-			case 't':  PUTC(c, '\t'); break;
-			case 'u': {
-				if (!(p = lept_parse_hex4(p, &u)))
-					STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
-				
-				if (u >= 0xD800 && u <= 0xDBFF) { /* surrogate pair */
-					if (*p++ != '\\')
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
-					if (*p++ != 'u')
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
-					if (!(p = lept_parse_hex4(p, &u2)))
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
-					if (u2 < 0xDC00 || u2 > 0xDFFF)
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
-					u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
-				}
-				lept_encode_utf8(c, u);
+#define LEPT_OBJECT_ROOM(v) ((v)->flags & LEPT_FLAG_CAPACITY ? LEPT_CAPACITY_HEADER((v)->u.o.m)->capacity : (v)->u.o.size)
+#define LEPT_OBJECT_SLOTS(v) ((uint32_t*)((v)->u.o.m + LEPT_OBJECT_ROOM(v)))
+
+// ԱҪlept_object_index_capacity()uint32Ŀռ
+static void lept_object_index_build(lept_value* v) {
+	size_t i, mask = lept_object_index_capacity(LEPT_OBJECT_ROOM(v)) - 1;
+	uint32_t* slots = LEPT_OBJECT_SLOTS(v);
+	memset(slots, 0, (mask + 1) * sizeof(uint32_t));
+	for (i = 0; i < v->u.o.size; i++) {
+		const lept_member* m = &v->u.o.m[i];
+		size_t h = ((v->flags & LEPT_FLAG_INTERNED) && m->klen > LEPT_SHORT_KEY_MAX ?
+			LEPT_INTERN_ENTRY(m->k.p)->hash : lept_hash_key(LEPT_KEY(m), m->klen)) & mask;
+		for (; slots[h]; h = (h + 1) & mask) {
+			// ظļֻһԲҵĽһ
+			const lept_member* o = &v->u.o.m[slots[h] - 1];
+			if (o->klen == m->klen && memcmp(LEPT_KEY(o), LEPT_KEY(m), m->klen) == 0)
 				break;
-			}
-			default:
-				STRING_ERROR(LEPT_PARSE_INVALID_STRING_ESCAPE);
-			}
-			break;
-		case '\0':
-			STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
-		default:
-			// TODO:\
-			// עunicodeҪע
-			if ((unsigned char)ch < 0x20) {
-				c->top = head;
-				STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
-			}
-			PUTC(c, ch);
 		}
+		if (!slots[h])
+			slots[h] = (uint32_t)(i + 1);
 	}
+	v->flags |= LEPT_FLAG_INDEXED;
 }
 
-static int lept_parse_string(lept_context* c, lept_value* v) {
-	int ret;
-	char* s;
-	size_t len;
-	if ((ret = lept_parse_string_raw(c, &s, &len)) == LEPT_PARSE_OK)
-		lept_set_string(v, s, len);
-	return ret;
-} // ַĺ
+size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen) {
+	size_t i;
+	assert(v != NULL && v->type == LEPT_OBJECT && key != NULL);
+	LEPT_EXPAND(v);
+	if (v->flags & LEPT_FLAG_INDEXED) {
+		size_t mask = lept_object_index_capacity(LEPT_OBJECT_ROOM(v)) - 1;
+		const uint32_t* slots = LEPT_OBJECT_SLOTS(v);
+		for (i = lept_hash_key(key, klen) & mask; slots[i]; i = (i + 1) & mask) {
+			const lept_member* m = &v->u.o.m[slots[i] - 1];
+			if (m->klen == klen && (LEPT_KEY(m) == key || memcmp(LEPT_KEY(m), key, klen) == 0))
+				return slots[i] - 1;
+		}
+		return LEPT_KEY_NOT_EXIST;
+	}
+	for (i = 0; i < v->u.o.size; i++)
+		if (v->u.o.m[i].klen == klen && (LEPT_KEY(&v->u.o.m[i]) == key || memcmp(LEPT_KEY(&v->u.o.m[i]), key, klen) == 0))
+			return i;
+	return LEPT_KEY_NOT_EXIST;
+}
 
+lept_value* lept_find_object_value(const lept_value* v, const char* key, size_t klen) {
+	size_t index = lept_find_object_index(v, key, klen);
+	return index != LEPT_KEY_NOT_EXIST ? &v->u.o.m[index].v : NULL;
+}
 
-static void lept_parse_whitespace(lept_context* c) {
-	const char *p = c->json;
-	while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
-		p++;
-	c->json = p;
+// ѵiԱӵõ˱֤ﻹû
+static void lept_object_index_add(lept_value* v, size_t i) {
+	size_t mask = lept_object_index_capacity(LEPT_OBJECT_ROOM(v)) - 1;
+	uint32_t* slots = LEPT_OBJECT_SLOTS(v);
+	const lept_member* m = &v->u.o.m[i];
+	size_t h = lept_hash_key(LEPT_KEY(m), m->klen) & mask;
+	while (slots[h])
+		h = (h + 1) & mask;
+	slots[h] = (uint32_t)(i + 1);
 }
 
-static int lept_parse_null(lept_context* c, lept_value* v) {
-	EXPECT(c, 'n');
-	if (c->json[0] != 'u' || c->json[1] != 'l' || c->json[2] != 'l')
-		return LEPT_PARSE_INVALID_VALUE;
-	c->json += 3;
-	v->type = LEPT_NULL;
-	return LEPT_PARSE_OK;
+///!*********************޸Ͷ*******************
+/*
+	/sizeԪءһҪռʱ򻻳ɴĲ֣
+	ǰһlept_capacity_headercapacityԪأ1.5
+	СLEPT_OBJECT_INDEX_MINĶ滹ŰĹϣ
+	׷ӵĳԱֱӼӽֻݺɾʱؽ԰ҲǾ̯O(1)ġ
+	lept_shrink_array/lept_shrink_objectؽֲ֡
+*/
+static size_t lept_container_size(const lept_value* v) {
+	return v->type == LEPT_ARRAY ? v->u.a.size : v->u.o.size;
 }
 
-static int lept_parse_false(lept_context* c, lept_value* v) {
-	EXPECT(c, 'f'); // һɹָ++
-	if (c->json[0] != 'a' || c->json[1] != 'l' || c->json[2] != 's' || c->json[3] != 'e')
-		return LEPT_PARSE_INVALID_VALUE;
-	c->json += 4;
-	v->type = LEPT_FALSE;
-	return LEPT_PARSE_OK;
+static size_t lept_container_capacity(const lept_value* v) {
+	if (v->flags & LEPT_FLAG_CAPACITY)
+		return LEPT_CAPACITY_HEADER(v->type == LEPT_ARRAY ? (void*)v->u.a.e : (void*)v->u.o.m)->capacity;
+	return lept_container_size(v);
 }
 
-static int lept_parse_true(lept_context* c, lept_value* v) {
-	EXPECT(c, 't'); // һɹָ++
-	if (c->json[0] != 'r' || c->json[1] != 'u' || c->json[2] != 'e')
-		return LEPT_PARSE_INVALID_VALUE;
-	c->json += 3;
-	v->type = LEPT_TRUE;
-	return LEPT_PARSE_OK;
+// capacityԪҪֽڣҪϹϣ
+static size_t lept_container_bytes(lept_type type, size_t capacity) {
+	if (type == LEPT_ARRAY)
+		return capacity * sizeof(lept_value);
+	return capacity * sizeof(lept_member) + (capacity >= LEPT_OBJECT_INDEX_MIN ? lept_object_index_capacity(capacity) * sizeof(uint32_t) : 0);
 }
 
-// 
-static int lept_parse_number(lept_context* c, lept_value* v) {
-	const char* p = c->json;
-	if (*p == '-') p++;
-	if (*p == '0')
-		p++;
+// capacityĲ֣capacityСԪظ
+static void lept_container_resize(lept_value* v, size_t capacity) {
+	void* e = v->type == LEPT_ARRAY ? (void*)v->u.a.e : (void*)v->u.o.m;
+	size_t bytes = sizeof(lept_capacity_header) + lept_container_bytes(v->type, capacity);
+	lept_capacity_header* h;
+	assert(capacity >= lept_container_size(v) && capacity > 0);
+	if (v->flags & LEPT_FLAG_CAPACITY)
+		h = (lept_capacity_header*)LEPT_REALLOC(LEPT_GLOBAL, LEPT_CAPACITY_HEADER(e), bytes);
 	else {
-		if (!ISDIGIT1TO9(*p)) return LEPT_PARSE_INVALID_VALUE;
-		for (p++; ISDIGIT(*p); p++);
+		size_t n = lept_container_size(v) * (v->type == LEPT_ARRAY ? sizeof(lept_value) : sizeof(lept_member));
+		h = (lept_capacity_header*)LEPT_MALLOC(LEPT_GLOBAL, bytes);
+		if (n)
+			memcpy(h + 1, e, n);
+		LEPT_FREE(LEPT_GLOBAL, e);
 	}
-	// 긺źСǰ
-	if (*p == '.') {
-		p++;
-		if (!ISDIGIT(*p)) return LEPT_PARSE_INVALID_VALUE;
-		for (p++; ISDIGIT(*p); p++);
+	h->capacity = capacity;
+	v->flags |= LEPT_FLAG_CAPACITY;
+	if (v->type == LEPT_ARRAY)
+		v->u.a.e = (lept_value*)(h + 1);
+	else {
+		v->u.o.m = (lept_member*)(h + 1);
+		v->flags &= ~LEPT_FLAG_INDEXED;
+		if (capacity >= LEPT_OBJECT_INDEX_MIN)
+			lept_object_index_build(v);
 	}
-	// С㵽e֮
-	if (*p == 'e' || *p == 'E') {
-		p++;
-		if (*p == '+' || *p == '-') p++;
-		if (!ISDIGIT(*p)) return LEPT_PARSE_INVALID_VALUE;
-		for (p++; ISDIGIT(*p); p++);
+}
+
+// ֤ٷһԪ
+static void lept_container_grow(lept_value* v) {
+	size_t size = lept_container_size(v);
+	if (size == lept_container_capacity(v))
+		lept_container_resize(v, size < 4 ? 4 : size + (size >> 1));
+}
+
+// sizeԪصĲ֣ĳԱʱͽһŹϣ
+static void lept_container_shrink(lept_value* v) {
+	void* e = v->type == LEPT_ARRAY ? (void*)v->u.a.e : (void*)v->u.o.m;
+	size_t size = lept_container_size(v);
+	lept_capacity_header* h = LEPT_CAPACITY_HEADER(e);
+	assert(v->flags & LEPT_FLAG_CAPACITY);
+	v->flags &= ~(LEPT_FLAG_CAPACITY | LEPT_FLAG_INDEXED);
+	e = NULL;
+	if (size) {
+		e = LEPT_MALLOC(LEPT_GLOBAL, lept_container_bytes(v->type, size));
+		memcpy(e, h + 1, size * (v->type == LEPT_ARRAY ? sizeof(lept_value) : sizeof(lept_member)));
 	}
-	errno = 0;
-	v->u.n = strtod(c->json, NULL);
-	if (errno == ERANGE && (v->u.n == HUGE_VAL || v->u.n == -HUGE_VAL))
-		return LEPT_PARSE_NUMBER_TOO_BIG;
+	LEPT_FREE(LEPT_GLOBAL, h);
+	if (v->type == LEPT_ARRAY)
+		v->u.a.e = (lept_value*)e;
+	else if ((v->u.o.m = (lept_member*)e) != NULL && size >= LEPT_OBJECT_INDEX_MIN)
+		lept_object_index_build(v);
+}
 
-	v->type = LEPT_NUMBER;
-	c->json = p;
-	return LEPT_PARSE_OK;
+void lept_set_array(lept_value* v, size_t capacity) {
+	assert(v != NULL);
+	lept_free(v);
+	v->type = LEPT_ARRAY;
+	v->u.a.e = NULL;
+	v->u.a.size = 0;
+	if (capacity > 0)
+		lept_container_resize(v, capacity);
+}
 
+size_t lept_get_array_capacity(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
+	return lept_container_capacity(v);
 }
 
-// 
-static int lept_parse_value(lept_context* c, lept_value* v); // ǰ
-static int lept_parse_array(lept_context* c, lept_value* v) {
-	int bad = 0;
-	size_t size = 0;
-	int ret;
-	EXPECT(c, '[');
-	lept_parse_whitespace(c);
-	if (*c->json == ']') {
-		c->json++;
-		v->type = LEPT_ARRAY;
-		v->u.a.size = 0;
-		v->u.a.e = NULL;
-		return LEPT_PARSE_OK;
-	}
+void lept_reserve_array(lept_value* v, size_t capacity) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
+	if (capacity > lept_container_capacity(v))
+		lept_container_resize(v, capacity);
+}
 
-	for (;;) {
-		lept_value e;
-		lept_init(&e);
-		if ((ret = lept_parse_value(c, &e)) != LEPT_PARSE_OK) {
-			bad = 1;
-			break;
-		}
-		
-		memcpy(lept_context_push(c, sizeof(lept_value)), &e, sizeof(lept_value));
-		size ++;
-		lept_parse_whitespace(c);
-		if (*c->json == ',') {
-			c->json++;
-			lept_parse_whitespace(c);
-		} else if (*c->json == ']') {
-			c->json ++;
-			v->type = LEPT_ARRAY;
-			v->u.a.size = size;
-			size *= sizeof(lept_value);
-			memcpy(v->u.a.e = (lept_value*)malloc(size), lept_context_pop(c, size), size);
-			return LEPT_PARSE_OK;
-		} else {
-			bad = 1;
-			ret = LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
-			break;
-		}
-	}
+void lept_shrink_array(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
+	if (v->flags & LEPT_FLAG_CAPACITY)
+		lept_container_shrink(v);
+}
 
-	if (bad) { //ش֮ǰҪͷЩʱĶջеֵ
-		size_t i = 0;
-		for (i = 0; i < size; i++) //ջеָ˵ͬʱͷջеÿvalueṹָڴ
-			lept_free((lept_value*)lept_context_pop(c, sizeof(lept_value)));
-		return ret;
-	}
+void lept_clear_array(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
+	lept_erase_array_element(v, 0, v->u.a.size);
 }
 
+lept_value* lept_pushback_array_element(lept_value* v) {
+	lept_value* e;
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
+	lept_container_grow(v);
+	e = &v->u.a.e[v->u.a.size++];
+	lept_init(e);
+	return e;
+}
 
-// 
-static int lept_parse_object(lept_context* c, lept_value* v) {
-	size_t i, size;
-	lept_member m;
-	int ret;
-	EXPECT(c, '{');
-	lept_parse_whitespace(c);
-	if (*c->json == '}') {
-		c->json++;
-		v->type = LEPT_OBJECT;
-		v->u.o.m = 0;
-		v->u.o.size = 0;
-		return LEPT_PARSE_OK;
-	}
-	m.k = NULL;
-	size = 0;
+void lept_popback_array_element(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
+	assert(v->u.a.size > 0);
+	lept_free(&v->u.a.e[--v->u.a.size]);
+}
+
+lept_value* lept_insert_array_element(lept_value* v, size_t index) {
+	lept_value* e;
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
+	assert(index <= v->u.a.size);
+	lept_container_grow(v);
+	e = &v->u.a.e[index];
+	memmove(e + 1, e, (v->u.a.size - index) * sizeof(lept_value));
+	v->u.a.size++;
+	lept_init(e);
+	return e;
+}
+
+void lept_erase_array_element(lept_value* v, size_t index, size_t count) {
+	size_t i;
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_EXPAND(v);
+	assert(index + count <= v->u.a.size);
+	for (i = index; i < index + count; i++)
+		lept_free(&v->u.a.e[i]);
+	if (count) {
+		memmove(&v->u.a.e[index], &v->u.a.e[index + count], (v->u.a.size - index - count) * sizeof(lept_value));
+		v->u.a.size -= count;
+	}
+}
+
+// ޸Ķ֮ǰչֵԭؽõļפеļԼһݣ
+// ٻɴĲ֣ĹϣڳԱ棬ԱһλþͲ
+static void lept_object_prepare(lept_value* v) {
+	size_t i;
+	LEPT_EXPAND(v);
+	if (v->flags & (LEPT_FLAG_BORROWED | LEPT_FLAG_INTERNED)) {
+		for (i = 0; i < v->u.o.size; i++) {
+			lept_member* m = &v->u.o.m[i];
+			if (m->klen > LEPT_SHORT_KEY_MAX) {
+				char* k = m->k.p;
+				memcpy(lept_key_buffer(NULL, m, m->klen), k, m->klen);
+				if (v->flags & LEPT_FLAG_INTERNED)
+					lept_intern_release(k);
+			}
+		}
+		v->flags &= ~(LEPT_FLAG_BORROWED | LEPT_FLAG_INTERNED);
+	}
+	if (!(v->flags & LEPT_FLAG_CAPACITY) && v->u.o.size > 0)
+		lept_container_resize(v, v->u.o.size);
+}
+
+void lept_set_object(lept_value* v, size_t capacity) {
+	assert(v != NULL);
+	lept_free(v);
+	v->type = LEPT_OBJECT;
+	v->u.o.m = NULL;
+	v->u.o.size = 0;
+	if (capacity > 0)
+		lept_container_resize(v, capacity);
+}
+
+size_t lept_get_object_capacity(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_EXPAND(v);
+	return lept_container_capacity(v);
+}
+
+void lept_reserve_object(lept_value* v, size_t capacity) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	lept_object_prepare(v);
+	if (capacity > lept_container_capacity(v))
+		lept_container_resize(v, capacity);
+}
+
+void lept_shrink_object(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_EXPAND(v);
+	if (v->flags & LEPT_FLAG_CAPACITY)
+		lept_container_shrink(v);
+}
+
+void lept_clear_object(lept_value* v) {
+	size_t i;
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	lept_object_prepare(v);
+	for (i = 0; i < v->u.o.size; i++) {
+		lept_key_free(&v->u.o.m[i], v->flags, LEPT_GLOBAL);
+		lept_free(&v->u.o.m[i].v);
+	}
+	v->u.o.size = 0;
+	if (v->flags & LEPT_FLAG_INDEXED)
+		lept_object_index_build(v);
+}
+
+lept_value* lept_set_object_value(lept_value* v, const char* key, size_t klen) {
+	lept_member* m;
+	size_t i;
+	assert(v != NULL && v->type == LEPT_OBJECT && (key != NULL || klen == 0));
+	lept_object_prepare(v);
+	// еļҵõkeyָԼļʱ򣬲֮ʧЧ
+	if ((i = lept_find_object_index(v, key, klen)) != LEPT_KEY_NOT_EXIST)
+		return &v->u.o.m[i].v;
+	lept_container_grow(v);
+	m = &v->u.o.m[i = v->u.o.size++];
+	LEPT_COPY(lept_key_buffer(NULL, m, klen), key, klen);
+	lept_init(&m->v);
+	if (v->flags & LEPT_FLAG_INDEXED)
+		lept_object_index_add(v, i);
+	return &m->v;
+}
+
+void lept_remove_object_value(lept_value* v, size_t index) {
+	lept_member* m;
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	lept_object_prepare(v);
+	assert(index < v->u.o.size);
+	m = &v->u.o.m[index];
+	lept_key_free(m, v->flags, LEPT_GLOBAL);
+	lept_free(&m->v);
+	memmove(m, m + 1, (v->u.o.size - index - 1) * sizeof(lept_member));
+	v->u.o.size--;
+	if (v->flags & LEPT_FLAG_INDEXED)
+		lept_object_index_build(v);
+}
+
+
+///!*********************פ*******************
+/*
+	ͶĹϣһǿѰַǼݣǰlept_intern_entry
+	۵2ݣĸһͷ
+*/
+void lept_intern_init(lept_intern* t) {
+	assert(t != NULL);
+	t->keys = NULL;
+	t->size = t->capacity = 0;
+}
+
+void lept_intern_free(lept_intern* t) {
+	size_t i;
+	assert(t != NULL);
+	for (i = 0; i < t->capacity; i++)
+		if (t->keys[i])
+			lept_intern_release(t->keys[i]);
+	LEPT_FREE(LEPT_GLOBAL, t->keys);
+	lept_intern_init(t);
+}
+
+static void lept_intern_grow(lept_intern* t) {
+	size_t i, j, cap = t->capacity ? t->capacity * 2 : 64;
+	char** keys = (char**)memset(LEPT_MALLOC(LEPT_GLOBAL, cap * sizeof(char*)), 0, cap * sizeof(char*));
+	for (i = 0; i < t->capacity; i++)
+		if (t->keys[i]) {
+			for (j = LEPT_INTERN_ENTRY(t->keys[i])->hash & (cap - 1); keys[j]; j = (j + 1) & (cap - 1))
+				;
+			keys[j] = t->keys[i];
+		}
+	LEPT_FREE(LEPT_GLOBAL, t->keys);
+	t->keys = keys;
+	t->capacity = cap;
+}
+
+// رеһݣüһûеʱӽȥ
+static char* lept_intern_get(lept_intern* t, const char* k, size_t klen) {
+	uint32_t h = lept_hash_key(k, klen);
+	lept_intern_entry* e;
+	size_t i, mask;
+	if (t->size * 2 >= t->capacity)
+		lept_intern_grow(t);
+	mask = t->capacity - 1;
+	for (i = h & mask; t->keys[i]; i = (i + 1) & mask) {
+		e = LEPT_INTERN_ENTRY(t->keys[i]);
+		if (e->hash == h && e->len == klen && memcmp(t->keys[i], k, klen) == 0) {
+			e->refs++;
+			return t->keys[i];
+		}
+	}
+	e = (lept_intern_entry*)LEPT_MALLOC(LEPT_GLOBAL, sizeof(lept_intern_entry) + klen + 1);
+	LEPT_STAT_ADD(mallocs, 1);
+	LEPT_STAT_ADD(malloc_bytes, sizeof(lept_intern_entry) + klen + 1);
+	e->refs = 2; // һõһ
+	e->len = klen;
+	e->hash = h;
+	t->keys[i] = (char*)e + sizeof(lept_intern_entry);
+	memcpy(t->keys[i], k, klen);
+	t->keys[i][klen] = '\0';
+	t->size++;
+	return t->keys[i];
+}
+
+// [k, k + klen)mļפʱ򳤼ӱȡ
+static void lept_context_key(lept_context* c, lept_member* m, const char* k, size_t klen) {
+	if (c->intern && klen > LEPT_SHORT_KEY_MAX) {
+		m->k.p = lept_intern_get(c->intern, k, klen);
+		m->klen = klen;
+	}
+	else
+		LEPT_COPY(lept_key_buffer(c, m, klen), k, klen);
+}
+
+
+///!*************************SIMDɨ******************************
+/*
+	ȵ㣺ĿհףԼַҵһ '"''\\' ߿ַ
+	汾16/32ֽڶĵַʼĶȡҳ
+	ֻҪһֽ[p, end)֮ڣͲendʱصend
+	ﳬ[p, end)ĲֿǱ̸߳ͷŻдڴ棬ASanTSan⼸
+	ĸ汾ڵһεõʱCPU
+*/
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8)
+#define LEPT_NO_SANITIZE __attribute__((no_sanitize("address", "thread")))
+#elif defined(__GNUC__) && __GNUC__ >= 5
+#define LEPT_NO_SANITIZE __attribute__((no_sanitize_address, no_sanitize_thread))
+#elif defined(__GNUC__)
+#define LEPT_NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+#define LEPT_NO_SANITIZE
+#endif
+#if defined(__GNUC__)
+#define LEPT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LEPT_TARGET_AVX2
+#endif
+
+static const char* lept_skip_whitespace_scalar(const char* p, const char* end) {
+	while (p != end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+		p++;
+	return p;
+}
+
+static const char* lept_scan_string_scalar(const char* p, const char* end) {
+	while (p != end && *p != '\"' && *p != '\\' && (unsigned char)*p >= 0x20)
+		p++;
+	return p;
+}
+
+#if defined(LEPT_SIMD_SSE2)
+static unsigned lept_ctz(unsigned x) {
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, x);
+	return (unsigned)i;
+#else
+	return (unsigned)__builtin_ctz(x);
+#endif
+}
+
+// 16ֽвǿհ׵Щλ
+LEPT_NO_SANITIZE static unsigned lept_nonspace_mask_sse2(const char* a) {
+	__m128i x = _mm_load_si128((const __m128i*)a);
+	__m128i ws = _mm_or_si128(
+		_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\t'))),
+		_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r'))));
+	return ~(unsigned)_mm_movemask_epi8(ws) & 0xFFFF;
+}
+
+// 16ֽ '"''\\'  < 0x20 Щλ
+LEPT_NO_SANITIZE static unsigned lept_special_mask_sse2(const char* a) {
+	__m128i x = _mm_load_si128((const __m128i*)a);
+	__m128i m = _mm_or_si128(
+		_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))),
+		_mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F))); // x <= 0x1F
+	return (unsigned)_mm_movemask_epi8(m);
+}
+
+LEPT_NO_SANITIZE static const char* lept_skip_whitespace_sse2(const char* p, const char* end) {
+	const char* a = (const char*)((uintptr_t)p & ~(uintptr_t)15);
+	unsigned mask;
+	if (p == end)
+		return p;
+	if ((mask = lept_nonspace_mask_sse2(a) >> (p - a)) != 0)
+		return p + lept_ctz(mask) < end ? p + lept_ctz(mask) : end;
+	for (a += 16; a < end; a += 16)
+		if ((mask = lept_nonspace_mask_sse2(a)) != 0)
+			return a + lept_ctz(mask) < end ? a + lept_ctz(mask) : end;
+	return end;
+}
+
+LEPT_NO_SANITIZE static const char* lept_scan_string_sse2(const char* p, const char* end) {
+	const char* a = (const char*)((uintptr_t)p & ~(uintptr_t)15);
+	unsigned mask;
+	if (p == end)
+		return p;
+	if ((mask = lept_special_mask_sse2(a) >> (p - a)) != 0)
+		return p + lept_ctz(mask) < end ? p + lept_ctz(mask) : end;
+	for (a += 16; a < end; a += 16)
+		if ((mask = lept_special_mask_sse2(a)) != 0)
+			return a + lept_ctz(mask) < end ? a + lept_ctz(mask) : end;
+	return end;
+}
+#endif
+
+#if defined(LEPT_SIMD_AVX2)
+LEPT_NO_SANITIZE LEPT_TARGET_AVX2 static unsigned lept_nonspace_mask_avx2(const char* a) {
+	__m256i x = _mm256_load_si256((const __m256i*)a);
+	__m256i ws = _mm256_or_si256(
+		_mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\t'))),
+		_mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\r'))));
+	return ~(unsigned)_mm256_movemask_epi8(ws);
+}
+
+LEPT_NO_SANITIZE LEPT_TARGET_AVX2 static unsigned lept_special_mask_avx2(const char* a) {
+	__m256i x = _mm256_load_si256((const __m256i*)a);
+	__m256i m = _mm256_or_si256(
+		_mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\"')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\'))),
+		_mm256_cmpeq_epi8(_mm256_max_epu8(x, _mm256_set1_epi8(0x1F)), _mm256_set1_epi8(0x1F)));
+	return (unsigned)_mm256_movemask_epi8(m);
+}
+
+LEPT_NO_SANITIZE LEPT_TARGET_AVX2 static const char* lept_skip_whitespace_avx2(const char* p, const char* end) {
+	const char* a = (const char*)((uintptr_t)p & ~(uintptr_t)31);
+	unsigned mask;
+	if (p == end)
+		return p;
+	if ((mask = lept_nonspace_mask_avx2(a) >> (p - a)) != 0)
+		return p + lept_ctz(mask) < end ? p + lept_ctz(mask) : end;
+	for (a += 32; a < end; a += 32)
+		if ((mask = lept_nonspace_mask_avx2(a)) != 0)
+			return a + lept_ctz(mask) < end ? a + lept_ctz(mask) : end;
+	return end;
+}
+
+LEPT_NO_SANITIZE LEPT_TARGET_AVX2 static const char* lept_scan_string_avx2(const char* p, const char* end) {
+	const char* a = (const char*)((uintptr_t)p & ~(uintptr_t)31);
+	unsigned mask;
+	if (p == end)
+		return p;
+	if ((mask = lept_special_mask_avx2(a) >> (p - a)) != 0)
+		return p + lept_ctz(mask) < end ? p + lept_ctz(mask) : end;
+	for (a += 32; a < end; a += 32)
+		if ((mask = lept_special_mask_avx2(a)) != 0)
+			return a + lept_ctz(mask) < end ? a + lept_ctz(mask) : end;
+	return end;
+}
+
+static int lept_cpu_has_avx2() {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return 0;
+	__cpuid(info, 1);
+	// ҪOSXSAVEҲϵͳYMMĴ
+	if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+		return 0;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// ׶νĵһ׶ãһη64ֽڣÿһλӦһֽ
+typedef struct {
+	uint64_t quote, backslash, space, op, control;
+	uint64_t open, close; // ʼͽţopҲ
+} lept_block;
+
+static void lept_classify_scalar(const char* s, lept_block* b) {
+	int i;
+	memset(b, 0, sizeof(*b));
+	for (i = 0; i < 64; i++) {
+		uint64_t bit = (uint64_t)1 << i;
+		switch (s[i]) {
+		case '\"': b->quote |= bit; break;
+		case '\\': b->backslash |= bit; break;
+		case ' ': case '\t': case '\n': case '\r': b->space |= bit; break;
+		case '{': case '[': b->open |= bit; b->op |= bit; break;
+		case '}': case ']': b->close |= bit; b->op |= bit; break;
+		case ':': case ',': b->op |= bit; break;
+		}
+		if ((unsigned char)s[i] < 0x20)
+			b->control |= bit;
+	}
+}
+
+#if defined(LEPT_SIMD_SSE2)
+static void lept_classify_sse2(const char* s, lept_block* b) {
+	uint64_t quote = 0, backslash = 0, space = 0, op = 0, control = 0, open = 0, close = 0;
+	int i;
+	for (i = 0; i < 64; i += 16) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(s + i));
+		__m128i y = _mm_or_si128(x, _mm_set1_epi8(0x20)); // '['']'0x20'{''}'
+		__m128i o = _mm_cmpeq_epi8(y, _mm_set1_epi8('{'));
+		__m128i e = _mm_cmpeq_epi8(y, _mm_set1_epi8('}'));
+		quote |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\"'))) << i;
+		backslash |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))) << i;
+		space |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r'))))) << i;
+		op |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(o, e),
+			_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(':')), _mm_cmpeq_epi8(x, _mm_set1_epi8(','))))) << i;
+		open |= (uint64_t)(unsigned)_mm_movemask_epi8(o) << i;
+		close |= (uint64_t)(unsigned)_mm_movemask_epi8(e) << i;
+		control |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F))) << i;
+	}
+	b->quote = quote;
+	b->backslash = backslash;
+	b->space = space;
+	b->op = op;
+	b->control = control;
+	b->open = open;
+	b->close = close;
+}
+#endif
+
+#if defined(LEPT_SIMD_AVX2)
+// հ׺ͽṹַò4λ16ֽڵı飬ֽԼ
+// λǵ4λԲϵֵλ1ֽڲ0ҲԲ
+LEPT_TARGET_AVX2 static void lept_classify_avx2(const char* s, lept_block* b) {
+	const __m256i space_table = _mm256_setr_epi8(
+		' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100,
+		' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100);
+	// '['']'0x20'{''}'':'','0x20䣻
+	// ǿַ0x1A0x0C0x20Ҳ':'','Ҫopȥ
+	const __m256i op_table = _mm256_setr_epi8(
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0);
+	uint64_t quote = 0, backslash = 0, space = 0, op = 0, control = 0, open = 0, close = 0;
+	int i;
+	for (i = 0; i < 64; i += 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)(s + i));
+		__m256i y = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+		__m256i c = _mm256_cmpeq_epi8(_mm256_max_epu8(x, _mm256_set1_epi8(0x1F)), _mm256_set1_epi8(0x1F));
+		quote |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\"'))) << i;
+		backslash |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\'))) << i;
+		space |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_shuffle_epi8(space_table, x), x)) << i;
+		op |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_andnot_si256(c, _mm256_cmpeq_epi8(_mm256_shuffle_epi8(op_table, y), y))) << i;
+		open |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(y, _mm256_set1_epi8('{'))) << i;
+		close |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(y, _mm256_set1_epi8('}'))) << i;
+		control |= (uint64_t)(unsigned)_mm256_movemask_epi8(c) << i;
+	}
+	b->quote = quote;
+	b->backslash = backslash;
+	b->space = space;
+	b->op = op;
+	b->control = control;
+	b->open = open;
+	b->close = close;
+}
+#endif
+
+static const char* lept_skip_whitespace_init(const char* p, const char* end);
+static const char* lept_scan_string_init(const char* p, const char* end);
+static void lept_classify_init(const char* s, lept_block* b);
+static const char* (*lept_skip_whitespace)(const char* p, const char* end) = lept_skip_whitespace_init;
+static const char* (*lept_scan_string)(const char* p, const char* end) = lept_scan_string_init;
+static void (*lept_classify)(const char* s, lept_block* b) = lept_classify_init;
+
+/*
+	ָڳصʱ(main֮ǰûб߳)ѡãֻ֮߳ͬʱҲûݾ
+	ּ֧ʱʼı˻صһεõʱѡʱֻlept_parse_ndjson֤ڿ֮߳ǰѡ
+*/
+#if defined(__GNUC__)
+static void lept_simd_select(void) __attribute__((constructor));
+#elif defined(_MSC_VER)
+static void lept_simd_select(void);
+#pragma section(".CRT$XCU", read)
+// staticûõstaticᱻŻ
+__declspec(allocate(".CRT$XCU")) void (*lept_simd_select_at_load)(void) = lept_simd_select;
+#endif
+
+#if !defined(NDEBUG)
+// 汾ķҪͱ汾һģһÿһֵֽһ
+static void lept_classify_check(void (*classify)(const char*, lept_block*)) {
+	lept_block a, b;
+	char s[64];
+	int i, j;
+	for (i = 0; i < 256; i += 64) {
+		for (j = 0; j < 64; j++)
+			s[j] = (char)(i + j);
+		lept_classify_scalar(s, &a);
+		classify(s, &b);
+		assert(memcmp(&a, &b, sizeof(a)) == 0);
+	}
+}
+#endif
+
+static void lept_simd_select(void) {
+	const char* (*skip)(const char*, const char*) = lept_skip_whitespace_scalar;
+	const char* (*scan)(const char*, const char*) = lept_scan_string_scalar;
+	void (*classify)(const char*, lept_block*) = lept_classify_scalar;
+	if (lept_skip_whitespace != lept_skip_whitespace_init) // Ѿѡˣд
+		return;
+#if defined(LEPT_SIMD_SSE2)
+	skip = lept_skip_whitespace_sse2;
+	scan = lept_scan_string_sse2;
+	classify = lept_classify_sse2;
+#endif
+#if defined(LEPT_SIMD_AVX2)
+	if (lept_cpu_has_avx2()) {
+		skip = lept_skip_whitespace_avx2;
+		scan = lept_scan_string_avx2;
+		classify = lept_classify_avx2;
+	}
+#endif
+#if !defined(NDEBUG)
+	lept_classify_check(classify);
+#endif
+	lept_skip_whitespace = skip;
+	lept_scan_string = scan;
+	lept_classify = classify;
+}
+
+static const char* lept_skip_whitespace_init(const char* p, const char* end) {
+	lept_simd_select();
+	return lept_skip_whitespace(p, end);
+}
+
+static const char* lept_scan_string_init(const char* p, const char* end) {
+	lept_simd_select();
+	return lept_scan_string(p, end);
+}
+
+static void lept_classify_init(const char* s, lept_block* b) {
+	lept_simd_select();
+	lept_classify(s, b);
+}
+
+///!*************************һЩĺ******************************
+// ַʼ
+
+/*
+	https://zhuanlan.zhihu.com/p/22731540?refer=json-tutorial
+	unicodeһ
+	ַ """\u20AC"""
+	ô16ƵĹ޷ֵĴСȻձжΪnַд뵽ֽд
+
+*/
+static const char* lept_parse_hex4(const char* p, const char* end, unsigned* u) {
+	// pʼĸַŵ޷U
+	int i;
+	*u = 0;
+	if (end - p < 4)
+		return NULL;
+	for (i = 0; i < 4; i++) {
+		char ch = *p++;
+		*u <<= 4;
+		if (ch >= '0' && ch <= '9')  *u |= ch - '0';
+		else if (ch >= 'A' && ch <= 'F')  *u |= ch - ('A' - 10);
+		else if (ch >= 'a' && ch <= 'f')  *u |= ch - ('a' - 10);
+		else return NULL;
+	}
+	return p;
+}
+
+static int lept_encode_utf8(char* buf, unsigned u) {
+	//һunsignedintתΪ׼1-4charдbufУдֽ0xffΪ˷ֹľ档
+	if (u <= 0x7F) {
+		buf[0] = u & 0xFF;
+		return 1;
+	}
+	else if (u <= 0x7FF) {
+		buf[0] = 0xC0 | ((u >> 6) & 0xFF);
+		buf[1] = 0x80 | (u & 0x3F);
+		return 2;
+	}
+	else if (u <= 0xFFFF) {
+		buf[0] = 0xE0 | ((u >> 12) & 0xFF);
+		buf[1] = 0x80 | ((u >> 6) & 0x3F);
+		buf[2] = 0x80 | (u & 0x3F);
+		return 3;
+	}
+	else {
+		assert(u <= 0x10FFFF);
+		buf[0] = 0xF0 | ((u >> 18) & 0xFF);
+		buf[1] = 0x80 | ((u >> 12) & 0x3F);
+		buf[2] = 0x80 | ((u >> 6) & 0x3F);
+		buf[3] = 0x80 | (u & 0x3F);
+		return 4;
+	}
+}
+
+// '\\'תУ*ppָ'\\'ַ1-4ֽдbufУֽŵn
+// תռ2ֽڣȶдbufָѾλ
+static int lept_parse_escape(const char** pp, const char* end, char* buf, int* n) {
+	const char* p = *pp;
+	unsigned u, u2;
+	*n = 1;
+	if (p == end)
+		return LEPT_PARSE_INVALID_STRING_ESCAPE;
+	switch (*p++) {
+	case '\"': *buf = '\"'; break;
+	case '\\': *buf = '\\'; break;
+	case '/':  *buf = '/';  break;
+	case 'b':  *buf = '\b'; break;
+	case 'f':  *buf = '\f'; break;
+	case 'n':  *buf = '\n'; break;
+	case 'r':  *buf = '\r'; break;
+	case 't':  *buf = '\t'; break;
+	case 'u':
+		if (!(p = lept_parse_hex4(p, end, &u)))
+			return LEPT_PARSE_INVALID_UNICODE_HEX;
+		if (u >= 0xD800 && u <= 0xDBFF) { /* surrogate pair */
+			if (end - p < 2 || *p++ != '\\')
+				return LEPT_PARSE_INVALID_UNICODE_SURROGATE;
+			if (*p++ != 'u')
+				return LEPT_PARSE_INVALID_UNICODE_SURROGATE;
+			if (!(p = lept_parse_hex4(p, end, &u2)))
+				return LEPT_PARSE_INVALID_UNICODE_HEX;
+			if (u2 < 0xDC00 || u2 > 0xDFFF)
+				return LEPT_PARSE_INVALID_UNICODE_SURROGATE;
+			u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
+		}
+		*n = lept_encode_utf8(buf, u);
+		break;
+	default:
+		return LEPT_PARSE_INVALID_STRING_ESCAPE;
+	}
+	*pp = p;
+	return LEPT_PARSE_OK;
+}
+
+#define STRING_ERROR(ret) do { c->top = head; return ret; } while(0)
+// ַѽдstrlen
+// strָ c->stack еԪأҪ c->stack
+static int lept_parse_string_raw(lept_context* c, char** str, size_t* plen) {
+	size_t head = c->top, len;
+	const char* p;
+	int ret, n;
+	EXPECT(c, '\"'); //ַӦԡͷ
+	p = c->json;
+	for (;;) {
+		// һֱһַ֮ǰַͨһԿջ
+		const char* q = lept_scan_string(p, c->end);
+		char ch;
+		if (q != p) {
+			memcpy(lept_context_push(c, q - p), p, q - p);
+			p = q;
+		}
+		if (p == c->end)
+			STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
+		ch = *p++;
+		switch (ch) {
+		case '\"': // ʾַѾ
+			len = c->top - head;
+			*str = (char*)lept_context_pop(c, len);
+			*plen = len;
+			c->json = p;
+			return LEPT_PARSE_OK;
+		case '\\': { // תַ
+			char buf[4];
+			if ((ret = lept_parse_escape(&p, c->end, buf, &n)) != LEPT_PARSE_OK)
+				STRING_ERROR(ret);
+			memcpy(lept_context_push(c, n), buf, n);
+			break;
+		}
+		default:
+			// ɨֻͣڿַϣַͨѾ
+			assert((unsigned char)ch < 0x20);
+			STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
+		}
+	}
+}
+
+// ԭؽַĽд뻺ӿͷź濪ʼ'\0'β
+// ԭĳдλdԶᳬλp
+static int lept_parse_string_insitu(lept_context* c, char** str, size_t* plen) {
+	char *head, *d;
+	const char* p;
+	int ret, n;
+	EXPECT(c, '\"');
+	p = c->json;
+	head = d = (char*)c->json;
+	for (;;) {
+		const char* q = lept_scan_string(p, c->end);
+		if (q != p) {
+			// ûתʱdpͬһλãҪƶ
+			if (d != p)
+				memmove(d, p, q - p);
+			d += q - p;
+			p = q;
+		}
+		if (p == c->end)
+			return LEPT_PARSE_MISS_QUOTATION_MARK;
+		switch (*p++) {
+		case '\"':
+			*d = '\0';
+			*str = head;
+			*plen = d - head;
+			c->json = p;
+			return LEPT_PARSE_OK;
+		case '\\':
+			if ((ret = lept_parse_escape(&p, c->end, d, &n)) != LEPT_PARSE_OK)
+				return ret;
+			d += n;
+			break;
+		default:
+			return LEPT_PARSE_INVALID_STRING_CHAR;
+		}
+	}
+}
+
+static int lept_parse_string(lept_context* c, lept_value* v) {
+	int ret;
+	char* s;
+	size_t len;
+	if (c->insitu) {
+		// ֱָ뻺ϱǣlept_freeʱͷ
+		if ((ret = lept_parse_string_insitu(c, &s, &len)) == LEPT_PARSE_OK) {
+			lept_free_with(v, c->alloc);
+			v->u.s.s = s;
+			v->u.s.len = len;
+			v->type = LEPT_STRING;
+			v->flags |= LEPT_FLAG_BORROWED;
+		}
+		return ret;
+	}
+	if ((ret = lept_parse_string_raw(c, &s, &len)) == LEPT_PARSE_OK) {
+		lept_free_with(v, c->alloc);
+		LEPT_COPY(lept_string_buffer(c, v, len), s, len);
+	}
+	return ret;
+} // ַĺ
+
+
+static void lept_parse_whitespace(lept_context* c) {
+	const char *p = c->json;
+	// յjsonֵ֮ûпհףȿһֽڣǿհ׾Ͳ汾
+	if (p != c->end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+		p = lept_skip_whitespace(p + 1, c->end);
+	c->json = p;
+}
+
+static int lept_parse_null(lept_context* c, lept_value* v) {
+	EXPECT(c, 'n');
+	if (c->end - c->json < 3 || c->json[0] != 'u' || c->json[1] != 'l' || c->json[2] != 'l')
+		return LEPT_PARSE_INVALID_VALUE;
+	c->json += 3;
+	v->type = LEPT_NULL;
+	return LEPT_PARSE_OK;
+}
+
+static int lept_parse_false(lept_context* c, lept_value* v) {
+	EXPECT(c, 'f'); // һɹָ++
+	if (c->end - c->json < 4 || c->json[0] != 'a' || c->json[1] != 'l' || c->json[2] != 's' || c->json[3] != 'e')
+		return LEPT_PARSE_INVALID_VALUE;
+	c->json += 4;
+	v->type = LEPT_FALSE;
+	return LEPT_PARSE_OK;
+}
+
+static int lept_parse_true(lept_context* c, lept_value* v) {
+	EXPECT(c, 't'); // һɹָ++
+	if (c->end - c->json < 3 || c->json[0] != 'r' || c->json[1] != 'u' || c->json[2] != 'e')
+		return LEPT_PARSE_INVALID_VALUE;
+	c->json += 3;
+	v->type = LEPT_TRUE;
+	return LEPT_PARSE_OK;
+}
+
+// תõ
+static void lept_mul128(uint64_t a, uint64_t b, uint64_t* hi, uint64_t* lo) {
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 r = (unsigned __int128)a * b;
+	*hi = (uint64_t)(r >> 64);
+	*lo = (uint64_t)r;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	*lo = _umul128(a, b, hi);
+#else
+	// 32λĸֻ
+	uint64_t a0 = a & 0xFFFFFFFF, a1 = a >> 32, b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+	uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+	uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+	*lo = (mid << 32) | (p00 & 0xFFFFFFFF);
+	*hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+static int lept_clz64(uint64_t x) {
+	int n = 0;
+	assert(x != 0);
+#if defined(__GNUC__)
+	n = __builtin_clzll(x);
+#else
+	while (!(x & ((uint64_t)1 << 63))) {
+		x <<= 1;
+		n++;
+	}
+#endif
+	return n;
+}
+
+/*
+	Eisel-Lemire㷨 w * 10^q ӽdoublewΪ0
+	128λضϵ5^qwȡλΪβw19λʮʱȷ
+	https://arxiv.org/abs/2101.11408
+	doubleλģʽ(λ)ʱ򷵻λģʽ
+*/
+static uint64_t lept_eisel_lemire(uint64_t w, int q) {
+	uint64_t hi, lo, hi2, lo2, mantissa;
+	int lz, upperbit, shift, power2;
+	const uint64_t* pow5;
+	if (q < LEPT_POW5_MIN)
+		return 0;
+	if (q > LEPT_POW5_MAX)
+		return (uint64_t)0x7FF << 52;
+	lz = lept_clz64(w);
+	w <<= lz;
+	pow5 = lept_pow5_128 + 2 * (q - LEPT_POW5_MIN);
+	lept_mul128(w, pow5[0], &hi, &lo);
+	// 9λȫ1ʱ򣬽ضӰ룬ٳϵ64λ
+	if ((hi & 0x1FF) == 0x1FF) {
+		lept_mul128(w, pow5[1], &hi2, &lo2);
+		lo += hi2;
+		if (hi2 > lo)
+			hi++;
+	}
+	upperbit = (int)(hi >> 63);
+	shift = upperbit + 64 - 52 - 3;
+	mantissa = hi >> shift;
+	// floor(log2(10^q)) + 63 + 1023
+	power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+	if (power2 <= 0) {
+		// ǹ
+		if (-power2 + 1 >= 64)
+			return 0;
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		power2 = mantissa < ((uint64_t)1 << 52) ? 0 : 1;
+		return (mantissa & (((uint64_t)1 << 52) - 1)) | ((uint64_t)power2 << 52);
+	}
+	// պdoubleмʱҪż룬ֻqȽСʱ
+	if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == hi)
+		mantissa &= ~(uint64_t)1;
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= ((uint64_t)2 << 52)) {
+		mantissa = (uint64_t)1 << 52;
+		power2++;
+	}
+	mantissa &= ~((uint64_t)1 << 52);
+	if (power2 >= 0x7FF)
+		return (uint64_t)0x7FF << 52;
+	return mantissa | ((uint64_t)power2 << 52);
+}
+
+// 10022ηdoubleȷʾ
+static const double lept_pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*
+	Чֳ19λʱwֻǽض˵ǰ19λʵֵww+1֮䣬
+	doubleһʱ򣬽wbitsһdouble
+	ôȷرȽʵֵߵеstrtodlocale
+	LEPT_DECIMAL_MAX_DIGITSλЧֲӰȽϵĽֻºǲȫ0
+*/
+#define LEPT_DECIMAL_MAX_DIGITS 780
+#define LEPT_BIG_WORDS 140 // Ƚϵ󶼲4000λ
+
+typedef struct {
+	uint32_t w[LEPT_BIG_WORDS]; // λǰ
+	int n;
+} lept_big;
+
+// b = b * m + a
+static void lept_big_mul_add(lept_big* b, uint32_t m, uint32_t a) {
+	uint64_t carry = a;
+	int i;
+	for (i = 0; i < b->n; i++) {
+		carry += (uint64_t)b->w[i] * m;
+		b->w[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	if (carry) {
+		assert(b->n < LEPT_BIG_WORDS);
+		b->w[b->n++] = (uint32_t)carry;
+	}
+}
+
+// b = b * 10^k
+static void lept_big_pow10(lept_big* b, int k) {
+	static const uint32_t pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+	for (; k >= 9; k -= 9)
+		lept_big_mul_add(b, 1000000000, 0);
+	lept_big_mul_add(b, pow10[k], 0);
+}
+
+// b = b * 2^k
+static void lept_big_shl(lept_big* b, int k) {
+	lept_big_mul_add(b, (uint32_t)1 << (k & 31), 0);
+	if (b->n && (k >>= 5)) {
+		assert(b->n + k <= LEPT_BIG_WORDS);
+		memmove(b->w + k, b->w, b->n * sizeof(uint32_t));
+		memset(b->w, 0, k * sizeof(uint32_t));
+		b->n += k;
+	}
+}
+
+static int lept_big_cmp(const lept_big* a, const lept_big* b) {
+	int i;
+	if (a->n != b->n)
+		return a->n < b->n ? -1 : 1;
+	for (i = a->n - 1; i >= 0; i--)
+		if (a->w[i] != b->w[i])
+			return a->w[i] < b->w[i] ? -1 : 1;
+	return 0;
+}
+
+// [p, end)ûиŵ֣bitsǽضϵЧĽȷĽ
+static uint64_t lept_decimal_round(const char* p, const char* end, uint64_t bits) {
+	lept_big x, h;
+	uint64_t m;
+	int nd = 0, k = 0, frac = 0, sticky = 0, exp = 0, eneg = 0, e2, cmp;
+	x.n = 0;
+	for (; p != end && (ISDIGIT(*p) || *p == '.'); p++) {
+		if (*p == '.')
+			frac = 1;
+		else if (nd == 0 && *p == '0') // ǰ
+			k -= frac;
+		else if (nd < LEPT_DECIMAL_MAX_DIGITS) {
+			lept_big_mul_add(&x, 10, *p - '0');
+			nd++;
+			k -= frac;
+		}
+		else {
+			sticky |= *p != '0';
+			k += !frac;
+		}
+	}
+	// 滹в0֣͵һλ1ȽϵĽһ
+	if (sticky) {
+		lept_big_mul_add(&x, 10, 1);
+		k--;
+	}
+	if (p != end && (*p == 'e' || *p == 'E')) {
+		p++;
+		if (*p == '+' || *p == '-')
+			eneg = *p++ == '-';
+		for (; p != end && ISDIGIT(*p); p++)
+			if (exp < 100000)
+				exp = exp * 10 + (*p - '0');
+	}
+	k += eneg ? -exp : exp;
+	if (k > 400 || k < -1200) // ѡһʱ򲻻ô/С
+		return bits;
+	// bits = m * 2^e2е (2m + 1) * 2^(e2 - 1)
+	e2 = (int)(bits >> 52);
+	m = bits & (((uint64_t)1 << 52) - 1);
+	if (e2)
+		m |= (uint64_t)1 << 52;
+	else
+		e2 = 1;
+	m = 2 * m + 1;
+	e2 -= 1075 + 1;
+	h.w[0] = (uint32_t)m;
+	h.w[1] = (uint32_t)(m >> 32);
+	h.n = h.w[1] ? 2 : 1;
+	if (k >= 0)
+		lept_big_pow10(&x, k);
+	else
+		lept_big_pow10(&h, -k);
+	if (e2 >= 0)
+		lept_big_shl(&h, e2);
+	else
+		lept_big_shl(&x, -e2);
+	cmp = lept_big_cmp(&x, &h);
+	return cmp > 0 || (cmp == 0 && (bits & 1)) ? bits + 1 : bits;
+}
+
+// ֣﷨ͬʱЧۼӵwУֻһ
+#define CH(p) ((p) != end ? *(p) : '\0')
+static int lept_parse_number(lept_context* c, lept_value* v) {
+	const char *p = c->json, *end = c->end;
+	uint64_t w = 0, bits;
+	int neg = 0, digits = 0, truncated = 0, q = 0, exp = 0;
+	double d;
+	if (CH(p) == '-') {
+		neg = 1;
+		p++;
+	}
+	if (CH(p) == '0')
+		p++;
+	else {
+		if (!ISDIGIT1TO9(CH(p))) return LEPT_PARSE_INVALID_VALUE;
+		for (; ISDIGIT(CH(p)); p++) {
+			// ۼ19λЧ֣uint64ֻ¼
+			if (digits < 19) {
+				w = w * 10 + (*p - '0');
+				digits++;
+			}
+			else {
+				q++;
+				truncated |= *p != '0';
+			}
+		}
+	}
+	// 긺źСǰ
+	if (CH(p) == '.') {
+		p++;
+		if (!ISDIGIT(CH(p))) return LEPT_PARSE_INVALID_VALUE;
+		for (; ISDIGIT(CH(p)); p++) {
+			if (digits < 19) {
+				w = w * 10 + (*p - '0');
+				if (w != 0) // Сǰ㲻Ч
+					digits++;
+				q--;
+			}
+			else
+				truncated |= *p != '0';
+		}
+	}
+	// С㵽e֮
+	if (CH(p) == 'e' || CH(p) == 'E') {
+		int eneg = 0;
+		p++;
+		if (CH(p) == '+' || CH(p) == '-')
+			eneg = *p++ == '-';
+		if (!ISDIGIT(CH(p))) return LEPT_PARSE_INVALID_VALUE;
+		for (; ISDIGIT(CH(p)); p++)
+			if (exp < 100000) // ٴָҲֻ0
+				exp = exp * 10 + (*p - '0');
+		q += eneg ? -exp : exp;
+	}
+
+	if (w == 0)
+		d = 0.0;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+	// β10ݶܾȷʾһγ˳ȷĽ
+	else if (!truncated && w <= ((uint64_t)1 << 53) && q >= -22 && q <= 22)
+		d = q < 0 ? (double)w / lept_pow10[-q] : (double)w * lept_pow10[q];
+#endif
+	else {
+		bits = lept_eisel_lemire(w, q);
+		// Чֳ19λʱʵֵww+1֮䣬һſȷټ
+		if (truncated && lept_eisel_lemire(w + 1, q) != bits)
+			bits = lept_decimal_round(c->json + neg, p, bits);
+		memcpy(&d, &bits, sizeof(d));
+	}
+	if (d == HUGE_VAL)
+		return LEPT_PARSE_NUMBER_TOO_BIG;
+	v->u.n = neg ? -d : d;
+	v->type = LEPT_NUMBER;
+	c->json = p;
+	return LEPT_PARSE_OK;
+}
+#undef CH
+
+// ջsizeԱƵv
+static void lept_context_pop_members(lept_context* c, lept_value* v, size_t size) {
+	size_t s = sizeof(lept_member) * size;
+	v->type = LEPT_OBJECT;
+	v->u.o.size = size;
+	if (size == 0)
+		v->u.o.m = NULL;
+	else if (size >= LEPT_OBJECT_INDEX_MIN) {
+		// ϣڳԱ棬һη
+		v->u.o.m = (lept_member*)lept_context_alloc(c, s + lept_object_index_capacity(size) * sizeof(uint32_t));
+		memcpy(v->u.o.m, lept_context_pop(c, s), s);
+		lept_object_index_build(v);
+	}
+	else
+		memcpy(v->u.o.m = (lept_member*)lept_context_alloc(c, s), lept_context_pop(c, s), s);
+}
+
+///!*************************Ͷ******************************
+/*
+	Ͷ󲻵ݹǶҲջ
+	ÿһ㣬c->stackѹһlept_frame¼һϢһԪ/Ա˳棬
+	ŵʱһƵ·ڴУΪһֵһ㡣
+	lept_parserõҲͬĲ֡
+*/
+typedef struct {
+	size_t parent;      // һframeջеλ
+	size_t size;        // һѾԪظ
+	lept_type type;     // LEPT_ARRAYLEPT_OBJECT
+	int key;            // ڽĳԱѾ˼m.k
+	lept_member m;
+} lept_frame;
+
+#define LEPT_FRAME_ROOT ((size_t)-1)
+// ѹջreallocframeǳջеλãõʱȡַ
+#define LEPT_FRAME(c, f) ((lept_frame*)((c)->stack + (f)))
+
+static size_t lept_frame_push(lept_context* c, size_t parent, lept_type type) {
+	lept_frame f;
+	size_t pos = c->top;
+	f.parent = parent;
+	f.size = 0;
+	f.type = type;
+	f.key = 0;
+	memcpy(lept_context_push(c, sizeof(f)), &f, sizeof(f));
+	return pos;
+}
+
+// һֵˣŵframeһ
+static void lept_frame_append(lept_context* c, size_t frame, const lept_value* e) {
+	lept_frame* f = LEPT_FRAME(c, frame);
+	if (f->type == LEPT_ARRAY)
+		memcpy(lept_context_push(c, sizeof(lept_value)), e, sizeof(lept_value));
+	else {
+		lept_member m = f->m;
+		m.v = *e;
+		f->key = 0;
+		memcpy(lept_context_push(c, sizeof(lept_member)), &m, sizeof(lept_member));
+	}
+	LEPT_FRAME(c, frame)->size++;
+}
+
+// ˽ţframeһԪƵeУһ
+static size_t lept_frame_close(lept_context* c, size_t frame, lept_value* e) {
+	lept_frame f;
+	memcpy(&f, LEPT_FRAME(c, frame), sizeof(f));
+	lept_init(e);
+	if (f.type == LEPT_ARRAY) {
+		size_t s = f.size * sizeof(lept_value);
+		e->type = LEPT_ARRAY;
+		e->u.a.size = f.size;
+		e->u.a.e = NULL;
+		if (s)
+			memcpy(e->u.a.e = (lept_value*)lept_context_alloc(c, s), lept_context_pop(c, s), s);
+	}
+	else {
+		if (c->insitu)
+			e->flags |= LEPT_FLAG_BORROWED; // 
+		else if (c->intern)
+			e->flags |= LEPT_FLAG_INTERNED;
+		lept_context_pop_members(c, e, f.size);
+	}
+	lept_context_pop(c, sizeof(f));
+	assert(c->top == frame);
+	return f.parent;
+}
+
+// ʱ򣬴frameʼͷÿһѾԪغͻûϵļջ˻ص֮ǰ
+static void lept_frame_discard(lept_context* c, size_t frame) {
+	int flags = c->insitu ? LEPT_FLAG_BORROWED : c->intern ? LEPT_FLAG_INTERNED : 0; // ô
+	while (frame != LEPT_FRAME_ROOT) {
+		lept_frame f;
+		char* e = c->stack + frame + sizeof(f);
+		size_t i;
+		memcpy(&f, LEPT_FRAME(c, frame), sizeof(f));
+		if (!c->arena) { // arenaеڴ
+			for (i = 0; i < f.size; i++) {
+				if (f.type == LEPT_ARRAY)
+					lept_free_with((lept_value*)e + i, c->alloc);
+				else {
+					lept_key_free((lept_member*)e + i, flags, c->alloc);
+					lept_free_with(&((lept_member*)e)[i].v, c->alloc);
+				}
+			}
+			if (f.key)
+				lept_key_free(&f.m, flags, c->alloc);
+		}
+		c->top = frame;
+		frame = f.parent;
+	}
+}
+
+// Աļͺðţframe
+static int lept_parse_key(lept_context* c, size_t frame) {
+	lept_frame* f;
+	char* k;
+	size_t klen;
+	int ret;
+	if (PEEK(c) != '"')
+		return LEPT_PARSE_MISS_KEY;
+	LEPT_STAT_START(LEPT_PHASE_STRING);
+	ret = c->insitu ? lept_parse_string_insitu(c, &k, &klen) : lept_parse_string_raw(c, &k, &klen);
+	LEPT_STAT_STOP(LEPT_PHASE_STRING);
+	if (ret != LEPT_PARSE_OK)
+		return ret;
+	f = LEPT_FRAME(c, frame);
+	if (c->insitu && klen > LEPT_SHORT_KEY_MAX) {
+		// ļֱָ뻺̵ļǷڳԱ
+		f->m.k.p = k;
+		f->m.klen = klen;
+	}
+	else
+		lept_context_key(c, &f->m, k, klen);
+	f->key = 1;
+	/* հ + ð + հ */
+	lept_parse_whitespace(c);
+	if (PEEK(c) != ':')
+		return LEPT_PARSE_MISS_COLON;
+	c->json++;
+	lept_parse_whitespace(c);
+	return LEPT_PARSE_OK;
+}
+
+static int lept_parse_value(lept_context* c, lept_value* v) {
+	size_t frame = LEPT_FRAME_ROOT, depth = 0;
+	lept_type type = LEPT_NULL; // ǰһͣڸLEPT_NULL
+	lept_value e;
+	int ret;
+	for (;;) {
+		// һֵŵeУͶֻǽµһ
+		lept_init(&e);
+		if (c->json == c->end) {
+			ret = LEPT_PARSE_EXPECT_VALUE;
+			break;
+		}
+		switch (*c->json) {
+		case 'n': ret = lept_parse_null(c, &e); break;
+		case 't': ret = lept_parse_true(c, &e); break;
+		case 'f': ret = lept_parse_false(c, &e); break;
+		case '\"':
+			LEPT_STAT_START(LEPT_PHASE_STRING);
+			ret = lept_parse_string(c, &e);
+			LEPT_STAT_STOP(LEPT_PHASE_STRING);
+			break;
+		case '[':
+		case '{':
+			if (++depth > c->max_depth) {
+				ret = LEPT_PARSE_DEPTH_EXCEEDED;
+				break;
+			}
+			LEPT_STAT_MAX(max_depth, depth);
+			e.type = *c->json++ == '[' ? LEPT_ARRAY : LEPT_OBJECT;
+			lept_parse_whitespace(c);
+			if (PEEK(c) == (e.type == LEPT_ARRAY ? ']' : '}')) {
+				c->json++;
+				depth--;
+				if (e.type == LEPT_ARRAY) {
+					e.u.a.e = NULL;
+					e.u.a.size = 0;
+				}
+				else {
+					e.u.o.m = NULL;
+					e.u.o.size = 0;
+				}
+				ret = LEPT_PARSE_OK;
+				break;
+			}
+			frame = lept_frame_push(c, frame, type = e.type);
+			if (type == LEPT_OBJECT && (ret = lept_parse_key(c, frame)) != LEPT_PARSE_OK)
+				break;
+			continue; // ŽһĵһԪ
+		default:
+			LEPT_STAT_START(LEPT_PHASE_NUMBER);
+			ret = lept_parse_number(c, &e);
+			LEPT_STAT_STOP(LEPT_PHASE_NUMBER);
+			break;
+		}
+		if (ret != LEPT_PARSE_OK)
+			break;
+
+		// eڵһ㣬һҲˣٽһ
+		for (;;) {
+			LEPT_STAT_ADD(values[e.type], 1);
+			if (frame == LEPT_FRAME_ROOT) {
+				*v = e;
+				return LEPT_PARSE_OK;
+			}
+			if (type == LEPT_ARRAY) {
+				memcpy(lept_context_push(c, sizeof(lept_value)), &e, sizeof(lept_value));
+				LEPT_FRAME(c, frame)->size++;
+			}
+			else
+				lept_frame_append(c, frame, &e);
+			lept_parse_whitespace(c);
+			if (PEEK(c) == ',') {
+				c->json++;
+				lept_parse_whitespace(c);
+				if (type == LEPT_OBJECT && (ret = lept_parse_key(c, frame)) != LEPT_PARSE_OK)
+					goto error;
+				break;
+			}
+			if (PEEK(c) != (type == LEPT_ARRAY ? ']' : '}')) {
+				ret = type == LEPT_ARRAY ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+				goto error;
+			}
+			c->json++;
+			depth--;
+			frame = lept_frame_close(c, frame, &e);
+			type = frame == LEPT_FRAME_ROOT ? LEPT_NULL : LEPT_FRAME(c, frame)->type;
+		}
+	}
+error:
+	lept_frame_discard(c, frame);
+	return ret;
+}
+
+// json-text  : ws + value + ws
+// ʱջɵõ׼ͷ
+static int lept_parse_root(lept_context* c, lept_value* v) {
+	const char* start = c->json;
+	int ret;
+	assert(v != NULL);
+	lept_init(v);
+
+	LEPT_STAT_START(LEPT_PHASE_PARSE);
+	lept_parse_whitespace(c);
+	if ((ret = lept_parse_value(c, v)) == LEPT_PARSE_OK) {
+		lept_parse_whitespace(c);
+		if (c->json != c->end) {
+			if (!c->arena)
+				lept_free_with(v, c->alloc);
+			v->type = LEPT_NULL;
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+		}
+	}
+	LEPT_STAT_STOP(LEPT_PHASE_PARSE);
+	LEPT_STAT_ADD(bytes, (size_t)(c->json - start));
+	return ret;
+}
+
+int lept_parse(lept_value* v, const char* json) {
+	assert(json != NULL);
+	return lept_parse_n(v, json, strlen(json));
+}
+
+int lept_parse_n(lept_value* v, const char* json, size_t len) {
+	lept_context c;
+	int ret;
+	assert(json != NULL || len == 0);
+	lept_context_init(&c, json, len);
+	ret = lept_parse_root(&c, v);
+	// ǲǳɹҪͷԴ
+	LEPT_FREE(c.alloc, c.stack);
+	return ret;
+}
+
+int lept_parse_with(lept_value* v, const char* json, size_t len, const lept_allocator* a) {
+	lept_context c;
+	int ret;
+	assert(json != NULL || len == 0);
+	lept_context_init(&c, json, len);
+	if (a)
+		c.alloc = a;
+	ret = lept_parse_root(&c, v);
+	LEPT_FREE(c.alloc, c.stack);
+	return ret;
+}
+
+int lept_parse_arena(lept_value* v, const char* json, lept_arena* a) {
+	lept_context c;
+	int ret;
+	assert(json != NULL);
+	lept_context_init(&c, json, strlen(json));
+	c.arena = a;
+	ret = lept_parse_root(&c, v);
+	LEPT_FREE(c.alloc, c.stack);
+	return ret;
+}
+
+int lept_parse_intern(lept_value* v, const char* json, size_t len, lept_intern* t) {
+	lept_context c;
+	int ret;
+	assert((json != NULL || len == 0) && t != NULL);
+	lept_context_init(&c, json, len);
+	c.intern = t;
+	ret = lept_parse_root(&c, v);
+	LEPT_FREE(c.alloc, c.stack);
+	return ret;
+}
+
+int lept_parse_insitu(lept_value* v, char* json) {
+	lept_context c;
+	int ret;
+	assert(json != NULL);
+	lept_context_init(&c, json, strlen(json));
+	c.insitu = 1;
+	ret = lept_parse_root(&c, v);
+	LEPT_FREE(c.alloc, c.stack);
+	return ret;
+}
+
+// ļӳ䵽ڴֱӽҲҪ'\0'β
+// ֻӳļļӳ䣬mapNULL
+typedef struct {
+	void* map;
+	size_t len;
+} lept_mapping;
+
+static int lept_map_file(lept_mapping* m, const char* path) {
+#if defined(_WIN32)
+	HANDLE f, h;
+	LARGE_INTEGER size;
+	m->map = NULL;
+	m->len = 0;
+	if ((f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL)) == INVALID_HANDLE_VALUE)
+		return LEPT_FILE_ERROR;
+	if (!GetFileSizeEx(f, &size) || (unsigned long long)size.QuadPart > (size_t)-1) {
+		CloseHandle(f);
+		return LEPT_FILE_ERROR;
+	}
+	if ((m->len = (size_t)size.QuadPart) == 0) {
+		CloseHandle(f);
+		return LEPT_PARSE_OK;
+	}
+	// ͼӳһֱЧȹص
+	if ((h = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL)) != NULL) {
+		m->map = MapViewOfFile(h, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(h);
+	}
+	CloseHandle(f);
+	return m->map ? LEPT_PARSE_OK : LEPT_FILE_ERROR;
+#else
+	struct stat st;
+	int fd;
+	m->map = NULL;
+	m->len = 0;
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return LEPT_FILE_ERROR;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (unsigned long long)st.st_size > (size_t)-1) {
+		close(fd);
+		return LEPT_FILE_ERROR;
+	}
+	if ((m->len = (size_t)st.st_size) == 0) {
+		close(fd);
+		return LEPT_PARSE_OK;
+	}
+	m->map = mmap(NULL, m->len, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // ӳ佨֮ͲҪfd
+	if (m->map == MAP_FAILED) {
+		m->map = NULL;
+		return LEPT_FILE_ERROR;
+	}
+#if defined(MADV_SEQUENTIAL)
+	madvise(m->map, m->len, MADV_SEQUENTIAL);
+#endif
+	return LEPT_PARSE_OK;
+#endif
+}
+
+static void lept_unmap_file(lept_mapping* m) {
+	if (m->map == NULL)
+		return;
+#if defined(_WIN32)
+	UnmapViewOfFile(m->map);
+#else
+	munmap(m->map, m->len);
+#endif
+}
+
+int lept_parse_file(lept_value* v, const char* path) {
+	lept_mapping m;
+	int ret;
+	assert(v != NULL && path != NULL);
+	lept_init(v);
+	if ((ret = lept_map_file(&m, path)) != LEPT_PARSE_OK)
+		return ret;
+	ret = lept_parse_n(v, m.map ? (const char*)m.map : "", m.len);
+	lept_unmap_file(&m);
+	return ret;
+}
+
+///!*************************׶ν******************************
+/*
+	ĵáһ׶ÿο64ֽڣλҳеĽṹַ
+	ַ{}[]:,ÿûбתšÿֺtrue/false/nullĵһֽڣ
+	λð˳ǵһڶ׶ֽհף
+	ûתַŵλö֪ˣֱӸƵյڴ
+	κһ׶ηֲԾlept_parse_n½Դlept_parseȫһ
+	lept_parse_nհ׺ɨַģʱmallocռ˴ͷ
+	һĵٶȲַ࣬ĵΪҪɨһ鷴bench structural
+*/
+static int lept_ctz64(uint64_t x) {
+	int n = 0;
+	assert(x != 0);
+#if defined(__GNUC__)
+	n = __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanForward64(&i, x);
+	n = (int)i;
+#else
+	while (!(x & 1)) {
+		x >>= 1;
+		n++;
+	}
+#endif
+	return n;
+}
+
+static int lept_popcount64(uint64_t x) {
+#if defined(__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	int n = 0;
+	for (; x; x &= x - 1)
+		n++;
+	return n;
+#endif
+}
+
+// ÿһλǰλ֮ȫ1
+static uint64_t lept_prefix_xor(uint64_t x) {
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+
+// رбתЩֽڣ*carryʾһһֽתһĵһֽ
+// бܺټһһ͹
+static uint64_t lept_escaped(uint64_t backslash, uint64_t* carry) {
+	uint64_t escaped = *carry, bit;
+	backslash &= ~*carry; // תķбܲתֽ
+	*carry = 0;
+	while (backslash) {
+		bit = backslash & (0 - backslash);
+		backslash ^= bit;
+		if (bit >> 63)
+			*carry = 1;
+		else {
+			escaped |= bit << 1;
+			backslash &= ~(bit << 1);
+		}
+	}
+	return escaped;
+}
+
+// һ׶Σṹַλд*indexУظ
+// ַûнַпַʱ򷵻0յĵҲ0Щlept_parse_n
+static size_t lept_index_build(const char* json, size_t len, uint32_t** index) {
+	uint32_t* idx = NULL;
+	size_t n = 0, cap = 0, pos;
+	uint64_t escape_carry = 0, string_carry = 0, scalar_carry = 0;
+	char tail[64];
+	for (pos = 0; pos < len; pos += 64) {
+		const char* s = json + pos;
+		lept_block b;
+		uint64_t quote, in_string, scalar, tokens;
+		if (len - pos < 64) {
+			// һÿհײ룬հײṹַ
+			memset(tail, ' ', sizeof(tail));
+			memcpy(tail, s, len - pos);
+			s = tail;
+		}
+		lept_classify(s, &b);
+		quote = b.quote & ~lept_escaped(b.backslash, &escape_carry);
+		// ַķΧͷţβ
+		in_string = lept_prefix_xor(quote) ^ string_carry;
+		string_carry = 0 - (in_string >> 63);
+		if (b.control & in_string)
+			goto fail;
+		// ַһβǿհסšṹַֽڣֻǵһֽ
+		scalar = ~(in_string | quote | b.space | b.op);
+		tokens = (b.op & ~in_string) | quote | (scalar & ~(scalar << 1 | scalar_carry));
+		scalar_carry = scalar >> 63;
+		if (n + 64 > cap) {
+			cap = cap ? cap + cap / 2 : len / 8 + 64;
+			idx = (uint32_t*)LEPT_REALLOC(LEPT_GLOBAL, idx, cap * sizeof(uint32_t));
+		}
+		while (tokens) {
+			idx[n++] = (uint32_t)(pos + lept_ctz64(tokens));
+			tokens &= tokens - 1;
+		}
+	}
+	if (string_carry == 0 && n) {
+		*index = idx;
+		return n;
+	}
+fail:
+	LEPT_FREE(LEPT_GLOBAL, idx);
+	*index = NULL;
+	return 0;
+}
+
+// ַ֮ûתʱ*sֱָ룬뵽ջϣ0
+static int lept_index_string(lept_context* c, const char* open, const char* close, const char** s, size_t* len) {
+	char* str;
+	if (!memchr(open + 1, '\\', close - open - 1)) {
+		*s = open + 1;
+		*len = close - open - 1;
+		return 1;
+	}
+	c->json = open;
+	if (lept_parse_string_raw(c, &str, len) != LEPT_PARSE_OK)
+		return 0;
+	assert(c->json == close + 1);
+	*s = str;
+	return 1;
+}
+
+// ļͺðţ*kָмͷ
+static int lept_index_key(lept_context* c, const char* json, const uint32_t* idx, size_t n, size_t* k, size_t frame) {
+	const char *p, *key;
+	size_t klen;
+	if (*k + 2 >= n || *(p = json + idx[*k]) != '\"')
+		return 0;
+	if (!lept_index_string(c, p, json + idx[*k + 1], &key, &klen))
+		return 0;
+	lept_context_key(c, &LEPT_FRAME(c, frame)->m, key, klen);
+	LEPT_FRAME(c, frame)->key = 1;
+	if (json[idx[*k + 2]] != ':')
+		return 0;
+	*k += 3;
+	return 1;
+}
+
+// ڶ׶Σlept_parse_valueһֻһַȡֻҪ˵
+static int lept_index_value(lept_context* c, const uint32_t* idx, size_t n, lept_value* v) {
+	const char* json = c->json;
+	const char *p, *s;
+	size_t k = 0, frame = LEPT_FRAME_ROOT, depth = 0, len;
+	lept_type type = LEPT_NULL;
+	lept_value e;
+	int ret;
+	for (;;) {
+		lept_init(&e);
+		if (k == n)
+			goto error;
+		p = json + idx[k++];
+		switch (*p) {
+		case '\"':
+			// βһһ
+			if (!lept_index_string(c, p, json + idx[k++], &s, &len))
+				goto error;
+			LEPT_COPY(lept_string_buffer(c, &e, len), s, len);
+			break;
+		case '[':
+		case '{':
+			if (++depth > c->max_depth)
+				goto error;
+			e.type = *p == '[' ? LEPT_ARRAY : LEPT_OBJECT;
+			if (k < n && json[idx[k]] == (e.type == LEPT_ARRAY ? ']' : '}')) {
+				k++;
+				depth--;
+				if (e.type == LEPT_ARRAY) {
+					e.u.a.e = NULL;
+					e.u.a.size = 0;
+				}
+				else {
+					e.u.o.m = NULL;
+					e.u.o.size = 0;
+				}
+				break;
+			}
+			frame = lept_frame_push(c, frame, type = e.type);
+			if (type == LEPT_OBJECT && !lept_index_key(c, json, idx, n, &k, frame))
+				goto error;
+			continue;
+		case ']': case '}': case ':': case ',':
+			goto error;
+		default:
+			c->json = p;
+			switch (*p) {
+			case 'n': ret = lept_parse_null(c, &e); break;
+			case 't': ret = lept_parse_true(c, &e); break;
+			case 'f': ret = lept_parse_false(c, &e); break;
+			default: ret = lept_parse_number(c, &e); break;
+			}
+			// ҪһֱհסŻ߽ṹַΪֹ"12a"ֺʣµĲûн
+			// յjsonŵľһṹַ
+			if (ret != LEPT_PARSE_OK || (c->json != c->end && (k == n || c->json != json + idx[k]) && *c->json != ' ' && *c->json != '\t' && *c->json != '\n' && *c->json != '\r'
+				&& *c->json != '\"' && *c->json != ',' && *c->json != ':' && *c->json != ']' && *c->json != '}' && *c->json != '[' && *c->json != '{'))
+				goto error;
+			break;
+		}
+
+		for (;;) {
+			if (frame == LEPT_FRAME_ROOT) {
+				if (k != n) {
+					lept_free(&e);
+					goto error;
+				}
+				*v = e;
+				return LEPT_PARSE_OK;
+			}
+			if (type == LEPT_ARRAY) {
+				memcpy(lept_context_push(c, sizeof(lept_value)), &e, sizeof(lept_value));
+				LEPT_FRAME(c, frame)->size++;
+			}
+			else
+				lept_frame_append(c, frame, &e);
+			if (k == n)
+				goto error;
+			p = json + idx[k++];
+			if (*p == ',') {
+				if (type == LEPT_OBJECT && !lept_index_key(c, json, idx, n, &k, frame))
+					goto error;
+				break;
+			}
+			if (*p != (type == LEPT_ARRAY ? ']' : '}'))
+				goto error;
+			depth--;
+			frame = lept_frame_close(c, frame, &e);
+			type = frame == LEPT_FRAME_ROOT ? LEPT_NULL : LEPT_FRAME(c, frame)->type;
+		}
+	}
+error:
+	lept_frame_discard(c, frame);
+	return LEPT_PARSE_INVALID_VALUE;
+}
+
+int lept_parse_structural(lept_value* v, const char* json, size_t len) {
+	lept_context c;
+	uint32_t* idx;
+	size_t n;
+	assert(v != NULL && (json != NULL || len == 0));
+	lept_init(v);
+	// λ32λ
+	if ((uint64_t)len <= 0xFFFFFFFFu && (n = lept_index_build(json, len, &idx)) != 0) {
+		int ret;
+		lept_context_init(&c, json, len);
+		ret = lept_index_value(&c, idx, n, v);
+		LEPT_FREE(c.alloc, c.stack);
+		LEPT_FREE(LEPT_GLOBAL, idx);
+		if (ret == LEPT_PARSE_OK)
+			return ret;
+	}
+	return lept_parse_n(v, json, len);
+}
+
+///!*******************************************************
+/*
+	lept_parse_lazyؼһ﷨lept_parseһǲ
+	ַ顢ֻԭĵķΧLEPT_FLAG_LAZYֺtrue/false/nullֱӽ
+	һֵʱչһ㣺ַ룬/ԼԪأ
+	Ԫַ顢ȻģֻźȥûʵĲֲڴ档
+*/
+
+// ַ﷨
+static int lept_check_string(lept_context* c) {
+	const char* p;
+	char buf[4];
+	int ret, n;
+	EXPECT(c, '\"');
+	p = c->json;
+	for (;;) {
+		p = lept_scan_string(p, c->end);
+		if (p == c->end)
+			return LEPT_PARSE_MISS_QUOTATION_MARK;
+		switch (*p++) {
+		case '\"':
+			c->json = p;
+			return LEPT_PARSE_OK;
+		case '\\':
+			if ((ret = lept_parse_escape(&p, c->end, buf, &n)) != LEPT_PARSE_OK)
+				return ret;
+			break;
+		default:
+			return LEPT_PARSE_INVALID_STRING_CHAR;
+		}
+	}
+}
+
+static int lept_check_key(lept_context* c) {
+	int ret;
+	if (PEEK(c) != '"')
+		return LEPT_PARSE_MISS_KEY;
+	if ((ret = lept_check_string(c)) != LEPT_PARSE_OK)
+		return ret;
+	lept_parse_whitespace(c);
+	if (PEEK(c) != ':')
+		return LEPT_PARSE_MISS_COLON;
+	c->json++;
+	lept_parse_whitespace(c);
+	return LEPT_PARSE_OK;
+}
+
+// lept_parse_value˳һֵ﷨ÿһջϼһֽ
+static int lept_check_value(lept_context* c) {
+	size_t base = c->top, depth = 0;
+	char type = 0; // ǰһ'[''{'ڸ0
+	lept_value e;
+	int ret;
+	for (;;) {
+		if (c->json == c->end) {
+			ret = LEPT_PARSE_EXPECT_VALUE;
+			break;
+		}
+		switch (*c->json) {
+		case 'n': ret = lept_parse_null(c, &e); break;
+		case 't': ret = lept_parse_true(c, &e); break;
+		case 'f': ret = lept_parse_false(c, &e); break;
+		case '\"': ret = lept_check_string(c); break;
+		case '[':
+		case '{':
+			if (++depth > c->max_depth) {
+				ret = LEPT_PARSE_DEPTH_EXCEEDED;
+				break;
+			}
+			type = *c->json++;
+			lept_parse_whitespace(c);
+			if (PEEK(c) == (type == '[' ? ']' : '}')) {
+				c->json++;
+				depth--;
+				type = c->top == base ? 0 : c->stack[c->top - 1];
+				ret = LEPT_PARSE_OK;
+				break;
+			}
+			PUTC(c, type);
+			if (type == '{' && (ret = lept_check_key(c)) != LEPT_PARSE_OK)
+				goto error;
+			continue;
+		default: ret = lept_parse_number(c, &e); break;
+		}
+		if (ret != LEPT_PARSE_OK)
+			break;
+
+		for (;;) {
+			if (c->top == base)
+				return LEPT_PARSE_OK;
+			lept_parse_whitespace(c);
+			if (PEEK(c) == ',') {
+				c->json++;
+				lept_parse_whitespace(c);
+				if (type == '{' && (ret = lept_check_key(c)) != LEPT_PARSE_OK)
+					goto error;
+				break;
+			}
+			if (PEEK(c) != (type == '[' ? ']' : '}')) {
+				ret = type == '[' ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+				goto error;
+			}
+			c->json++;
+			depth--;
+			c->top--;
+			type = c->top == base ? 0 : c->stack[c->top - 1];
+		}
+	}
+error:
+	c->top = base;
+	return ret;
+}
+
+// һѾַ//
+// Ͷõһ׶εķһο64ֽڣһĽŲȼ0ʱ
+static const char* lept_lazy_skip(const char* p, const char* end) {
+	uint64_t escape_carry = 0, string_carry = 0;
+	size_t depth = 0;
+	char tail[64];
+	if (*p == '\"') {
+		while (*(p = lept_scan_string(p + 1, end)) != '\"')
+			p++; // бܺһֽڸ
+		return p + 1;
+	}
+	for (;; p += 64) {
+		const char* s = p;
+		lept_block b;
+		uint64_t quote, in_string, open, close, bit;
+		if (end - p < 64) {
+			memset(tail, ' ', sizeof(tail));
+			memcpy(tail, p, end - p);
+			s = tail;
+		}
+		lept_classify(s, &b);
+		quote = b.quote & ~lept_escaped(b.backslash, &escape_carry);
+		in_string = lept_prefix_xor(quote) ^ string_carry;
+		string_carry = 0 - (in_string >> 63);
+		open = b.open & ~in_string;
+		close = b.close & ~in_string;
+		if (depth > (size_t)lept_popcount64(close)) {
+			depth += lept_popcount64(open) - lept_popcount64(close);
+			continue;
+		}
+		for (bit = open | close; bit; bit &= bit - 1) {
+			if (open & bit & (0 - bit))
+				depth++;
+			else if (--depth == 0)
+				return p + lept_ctz64(bit) + 1;
+		}
+	}
+}
+
+// һѾֵַ顢ֻԭĵķΧ
+static void lept_lazy_value(lept_context* c, lept_value* v) {
+	lept_init(v);
+	switch (*c->json) {
+	case 'n': lept_parse_null(c, v); break;
+	case 't': lept_parse_true(c, v); break;
+	case 'f': lept_parse_false(c, v); break;
+	case '\"':
+	case '[':
+	case '{':
+		v->type = *c->json == '\"' ? LEPT_STRING : *c->json == '[' ? LEPT_ARRAY : LEPT_OBJECT;
+		v->flags = LEPT_FLAG_LAZY;
+		v->u.s.s = (char*)c->json; // ֻͨ޸
+		c->json = lept_lazy_skip(c->json, c->end);
+		v->u.s.len = c->json - v->u.s.s;
+		break;
+	default: lept_parse_number(c, v); break;
+	}
+}
+
+static void lept_lazy_expand(lept_value* v) {
+	lept_context c;
+	lept_type type = v->type;
+	size_t n = 0;
+	lept_context_init(&c, v->u.s.s, v->u.s.len);
+	lept_init(v);
+	if (type == LEPT_STRING)
+		lept_parse_string(&c, v);
+	else {
+		c.json++;
+		lept_parse_whitespace(&c);
+		while (*c.json != (type == LEPT_ARRAY ? ']' : '}')) {
+			if (type == LEPT_ARRAY)
+				lept_lazy_value(&c, (lept_value*)lept_context_push(&c, sizeof(lept_value)));
+			else {
+				// ֱӽ룬ȸƳѹԱѹջrealloc
+				lept_member m;
+				char* str;
+				size_t klen;
+				lept_parse_string_raw(&c, &str, &klen);
+				LEPT_COPY(lept_key_buffer(&c, &m, klen), str, klen);
+				lept_parse_whitespace(&c);
+				c.json++; // ':'
+				lept_parse_whitespace(&c);
+				lept_lazy_value(&c, &m.v);
+				memcpy(lept_context_push(&c, sizeof(lept_member)), &m, sizeof(m));
+			}
+			n++;
+			lept_parse_whitespace(&c);
+			if (*c.json == ',') {
+				c.json++;
+				lept_parse_whitespace(&c);
+			}
+		}
+		if (type == LEPT_ARRAY) {
+			v->type = LEPT_ARRAY;
+			v->u.a.size = n;
+			v->u.a.e = NULL;
+			if (n)
+				memcpy(v->u.a.e = (lept_value*)LEPT_MALLOC(LEPT_GLOBAL, n * sizeof(lept_value)), lept_context_pop(&c, n * sizeof(lept_value)), n * sizeof(lept_value));
+		}
+		else
+			lept_context_pop_members(&c, v, n);
+	}
+	LEPT_FREE(c.alloc, c.stack);
+}
+
+int lept_parse_lazy(lept_value* v, const char* json, size_t len) {
+	lept_context c;
+	const char* start;
+	int ret;
+	assert(v != NULL && (json != NULL || len == 0));
+	lept_init(v);
+	lept_context_init(&c, json, len);
+	lept_parse_whitespace(&c);
+	start = c.json;
+	if ((ret = lept_check_value(&c)) == LEPT_PARSE_OK) {
+		const char* stop = c.json;
+		lept_parse_whitespace(&c);
+		if (c.json != c.end)
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+		else if (*start == '\"' || *start == '[' || *start == '{') {
+			v->type = *start == '\"' ? LEPT_STRING : *start == '[' ? LEPT_ARRAY : LEPT_OBJECT;
+			v->flags = LEPT_FLAG_LAZY;
+			v->u.s.s = (char*)start;
+			v->u.s.len = stop - start;
+		}
+		else {
+			c.json = start;
+			lept_lazy_value(&c, v);
+		}
+	}
+	LEPT_FREE(c.alloc, c.stack);
+	return ret;
+}
+
+void lept_expand(lept_value* v) {
+	lept_walk w;
+	size_t i;
+	assert(v != NULL);
+	lept_walk_init(&w, LEPT_GLOBAL);
+	lept_walk_push(&w, v);
+	while (w.top) {
+		lept_value* x = (lept_value*)w.e[--w.top].v;
+		LEPT_EXPAND(x);
+		// Ѿչ/Ҳֵܻ
+		if (x->type == LEPT_ARRAY) {
+			for (i = 0; i < x->u.a.size; i++)
+				if (x->u.a.e[i].flags & LEPT_FLAG_LAZY || x->u.a.e[i].type >= LEPT_ARRAY)
+					lept_walk_push(&w, &x->u.a.e[i]);
+		}
+		else if (x->type == LEPT_OBJECT) {
+			for (i = 0; i < x->u.o.size; i++)
+				if (x->u.o.m[i].v.flags & LEPT_FLAG_LAZY || x->u.o.m[i].v.type >= LEPT_ARRAY)
+					lept_walk_push(&w, &x->u.o.m[i].v);
+		}
+	}
+	lept_walk_free(&w);
+}
+
+///!*************************ṹ******************************
+/*
+	lept_parse_object﷨һÿңҵ˰ֶεͽֱдṹ壬
+	Ҳֵlept_check_valueֻݹ飬ݹĲĲ
+*/
+static int lept_into_object(lept_context* c, char* s, const lept_field* fields);
+
+// ǲnamek'\0'
+static int lept_field_match(const char* name, const char* k, size_t klen) {
+	size_t i;
+	for (i = 0; i < klen; i++)
+		if (name[i] != k[i] || name[i] == '\0')
+			return 0;
+	return name[klen] == '\0';
+}
+
+// ˳һ˳һһҵֶκ濪ʼ
+static const lept_field* lept_field_find(const lept_field* fields, const lept_field* hint, const char* k, size_t klen) {
+	const lept_field* f;
+	for (f = hint; f->name; f++)
+		if (lept_field_match(f->name, k, klen))
+			return f;
+	for (f = fields; f != hint; f++)
+		if (lept_field_match(f->name, k, klen))
+			return f;
+	return NULL;
+}
+
+// Ͳԣֵ﷨ʱȱ﷨
+static int lept_into_mismatch(lept_context* c) {
+	int ret = lept_check_value(c);
+	return ret != LEPT_PARSE_OK ? ret : LEPT_PARSE_TYPE_MISMATCH;
+}
+
+// ֶfͽһֵдp
+static int lept_into_value(lept_context* c, char* p, const lept_field* f) {
+	lept_value e;
+	char* str;
+	size_t len;
+	int ret;
+	lept_init(&e);
+	if (PEEK(c) == 'n')
+		return lept_parse_null(c, &e); // nullʲôд
+	switch (f->type) {
+	case LEPT_FALSE:
+	case LEPT_TRUE:
+		if (PEEK(c) == 't')
+			ret = lept_parse_true(c, &e);
+		else if (PEEK(c) == 'f')
+			ret = lept_parse_false(c, &e);
+		else
+			return lept_into_mismatch(c);
+		if (ret == LEPT_PARSE_OK)
+			*(int*)p = e.type == LEPT_TRUE;
+		return ret;
+	case LEPT_NUMBER:
+		if (PEEK(c) != '-' && !ISDIGIT(PEEK(c)))
+			return lept_into_mismatch(c);
+		if ((ret = lept_parse_number(c, &e)) == LEPT_PARSE_OK)
+			*(double*)p = e.u.n;
+		return ret;
+	case LEPT_STRING:
+		if (PEEK(c) != '\"')
+			return lept_into_mismatch(c);
+		if ((ret = lept_parse_string_raw(c, &str, &len)) != LEPT_PARSE_OK)
+			return ret;
+		LEPT_FREE(LEPT_GLOBAL, *(char**)p);
+		memcpy(*(char**)p = (char*)LEPT_MALLOC(LEPT_GLOBAL, len + 1), str, len);
+		(*(char**)p)[len] = '\0';
+		return LEPT_PARSE_OK;
+	case LEPT_OBJECT:
+		if (PEEK(c) != '{')
+			return lept_into_mismatch(c);
+		return lept_into_object(c, p, f->fields);
+	case LEPT_ARRAY:
+		if (PEEK(c) != '[')
+			return lept_into_mismatch(c);
+		/* fall through */
+	default:
+		lept_free((lept_value*)p);
+		return lept_parse_value(c, (lept_value*)p);
+	}
+}
+
+static int lept_into_object(lept_context* c, char* s, const lept_field* fields) {
+	const lept_field *hint = fields, *f;
+	char* k;
+	size_t klen;
+	int ret;
+	EXPECT(c, '{');
+	lept_parse_whitespace(c);
+	if (PEEK(c) == '}') {
+		c->json++;
+		return LEPT_PARSE_OK;
+	}
+	for (;;) {
+		if (PEEK(c) != '"')
+			return LEPT_PARSE_MISS_KEY;
+		if ((ret = lept_parse_string_raw(c, &k, &klen)) != LEPT_PARSE_OK)
+			return ret;
+		f = lept_field_find(fields, hint, k, klen); // kջϣһѹջ֮ǰ
+		lept_parse_whitespace(c);
+		if (PEEK(c) != ':')
+			return LEPT_PARSE_MISS_COLON;
+		c->json++;
+		lept_parse_whitespace(c);
+		if (f == NULL)
+			ret = lept_check_value(c);
+		else {
+			ret = lept_into_value(c, s + f->offset, f);
+			hint = f[1].name ? f + 1 : fields;
+		}
+		if (ret != LEPT_PARSE_OK)
+			return ret;
+		lept_parse_whitespace(c);
+		if (PEEK(c) == ',') {
+			c->json++;
+			lept_parse_whitespace(c);
+		}
+		else if (PEEK(c) == '}') {
+			c->json++;
+			return LEPT_PARSE_OK;
+		}
+		else
+			return LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+	}
+}
+
+int lept_parse_into(void* s, const lept_field* fields, const char* json, size_t len) {
+	lept_context c;
+	int ret;
+	assert(s != NULL && fields != NULL && (json != NULL || len == 0));
+	lept_context_init(&c, json, len);
+	lept_parse_whitespace(&c);
+	ret = PEEK(&c) == '{' ? lept_into_object(&c, (char*)s, fields) : lept_into_mismatch(&c);
+	if (ret == LEPT_PARSE_OK) {
+		lept_parse_whitespace(&c);
+		if (c.json != c.end)
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+	}
+	if (ret != LEPT_PARSE_OK)
+		lept_free_into(s, fields);
+	LEPT_FREE(c.alloc, c.stack);
+	return ret;
+}
+
+void lept_free_into(void* s, const lept_field* fields) {
+	const lept_field* f;
+	assert(s != NULL && fields != NULL);
+	for (f = fields; f->name; f++) {
+		char* p = (char*)s + f->offset;
+		switch (f->type) {
+		case LEPT_STRING:
+			LEPT_FREE(LEPT_GLOBAL, *(char**)p);
+			*(char**)p = NULL;
+			break;
+		case LEPT_OBJECT:
+			lept_free_into(p, f->fields);
+			break;
+		case LEPT_ARRAY:
+		case LEPT_NULL:
+			lept_free((lept_value*)p);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+///!*************************SAX¼******************************
+/*
+	ÿһֵ͵һλص﷨ʹlept_parseȫһ
+	ҪڴֻеݹȺ͵ǰַĳ
+*/
+// ַc->stackУΪ˷صں油һ'\0'
+static int lept_sax_string_raw(lept_context* c, const char** str, size_t* len) {
+	char* s;
+	int ret;
+	if ((ret = lept_parse_string_raw(c, &s, len)) != LEPT_PARSE_OK)
+		return ret;
+	c->top += *len;
+	PUTC(c, '\0');
+	c->top -= *len + 1;
+	*str = c->stack + c->top; // PUTCreallocˣȡַ
+	return LEPT_PARSE_OK;
+}
+
+static int lept_sax_value(lept_context* c, const lept_sax_handler* h, void* user);
+
+static int lept_sax_array(lept_context* c, const lept_sax_handler* h, void* user) {
+	size_t size = 0;
+	int ret;
+	EXPECT(c, '[');
+	if (h->start_array && !h->start_array(user))
+		return LEPT_PARSE_ABORTED;
+	lept_parse_whitespace(c);
+	if (PEEK(c) == ']') {
+		c->json++;
+		return h->end_array && !h->end_array(user, 0) ? LEPT_PARSE_ABORTED : LEPT_PARSE_OK;
+	}
+	for (;;) {
+		if ((ret = lept_sax_value(c, h, user)) != LEPT_PARSE_OK)
+			return ret;
+		size++;
+		lept_parse_whitespace(c);
+		if (PEEK(c) == ',') {
+			c->json++;
+			lept_parse_whitespace(c);
+		}
+		else if (PEEK(c) == ']') {
+			c->json++;
+			return h->end_array && !h->end_array(user, size) ? LEPT_PARSE_ABORTED : LEPT_PARSE_OK;
+		}
+		else
+			return LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+	}
+}
+
+static int lept_sax_object(lept_context* c, const lept_sax_handler* h, void* user) {
+	size_t size = 0, klen;
+	const char* k;
+	int ret;
+	EXPECT(c, '{');
+	if (h->start_object && !h->start_object(user))
+		return LEPT_PARSE_ABORTED;
+	lept_parse_whitespace(c);
+	if (PEEK(c) == '}') {
+		c->json++;
+		return h->end_object && !h->end_object(user, 0) ? LEPT_PARSE_ABORTED : LEPT_PARSE_OK;
+	}
 	for (;;) {
-		char* str;
-		lept_init(&m.v);
-		// Աļ-ַ
-		if (*c->json != '"') {
-			ret = LEPT_PARSE_MISS_KEY;
+		if (PEEK(c) != '"')
+			return LEPT_PARSE_MISS_KEY;
+		if ((ret = lept_sax_string_raw(c, &k, &klen)) != LEPT_PARSE_OK)
+			return ret;
+		if (h->key && !h->key(user, k, klen))
+			return LEPT_PARSE_ABORTED;
+		lept_parse_whitespace(c);
+		if (PEEK(c) != ':')
+			return LEPT_PARSE_MISS_COLON;
+		c->json++;
+		lept_parse_whitespace(c);
+		if ((ret = lept_sax_value(c, h, user)) != LEPT_PARSE_OK)
+			return ret;
+		size++;
+		lept_parse_whitespace(c);
+		if (PEEK(c) == ',') {
+			c->json++;
+			lept_parse_whitespace(c);
+		}
+		else if (PEEK(c) == '}') {
+			c->json++;
+			return h->end_object && !h->end_object(user, size) ? LEPT_PARSE_ABORTED : LEPT_PARSE_OK;
+		}
+		else
+			return LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+	}
+}
+
+// lept_parse_*һʱlept_valueٽص
+static int lept_sax_value(lept_context* c, const lept_sax_handler* h, void* user) {
+	lept_value v;
+	const char* s;
+	size_t len;
+	int ret, go = 1;
+	lept_init(&v);
+	if (c->json == c->end)
+		return LEPT_PARSE_EXPECT_VALUE;
+	switch (*c->json) {
+	case 'n':
+		if ((ret = lept_parse_null(c, &v)) == LEPT_PARSE_OK && h->null)
+			go = h->null(user);
+		break;
+	case 't':
+		if ((ret = lept_parse_true(c, &v)) == LEPT_PARSE_OK && h->boolean)
+			go = h->boolean(user, 1);
+		break;
+	case 'f':
+		if ((ret = lept_parse_false(c, &v)) == LEPT_PARSE_OK && h->boolean)
+			go = h->boolean(user, 0);
+		break;
+	case '\"':
+		if ((ret = lept_sax_string_raw(c, &s, &len)) == LEPT_PARSE_OK && h->string)
+			go = h->string(user, s, len);
+		break;
+	case '[':
+	case '{':
+		// SAXǵݹģ˲ƣջҲ޵
+		if (++c->depth > c->max_depth)
+			return LEPT_PARSE_DEPTH_EXCEEDED;
+		ret = *c->json == '[' ? lept_sax_array(c, h, user) : lept_sax_object(c, h, user);
+		c->depth--;
+		return ret;
+	default:
+		if ((ret = lept_parse_number(c, &v)) == LEPT_PARSE_OK && h->number)
+			go = h->number(user, v.u.n);
+		break;
+	}
+	return go ? ret : LEPT_PARSE_ABORTED;
+}
+
+static int lept_sax_root(lept_context* c, const lept_sax_handler* h, void* user) {
+	int ret;
+	lept_parse_whitespace(c);
+	if ((ret = lept_sax_value(c, h, user)) == LEPT_PARSE_OK) {
+		lept_parse_whitespace(c);
+		if (c->json != c->end)
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+	}
+	LEPT_FREE(c->alloc, c->stack);
+	return ret;
+}
+
+int lept_parse_sax(const char* json, const lept_sax_handler* handler, void* user) {
+	lept_context c;
+	assert(json != NULL && handler != NULL);
+	lept_context_init(&c, json, strlen(json));
+	return lept_sax_root(&c, handler, user);
+}
+
+///!*************************tape******************************
+/*
+	ÿֵĸ8λlept_type56λͲͬ
+	null/false/true
+	֣ãһdoubleĸλ
+	ַstringsеλãȷsize_tĳȣٷݺ'\0'
+	//Ǹֵ±ꣻһԪ/ԱٺԪأǼ(ַ)ֵ
+*/
+#define LEPT_TAPE_WORD(type, payload) ((uint64_t)(type) << 56 | (uint64_t)(payload))
+#define LEPT_TAPE_TYPE(w)             ((lept_type)((w) >> 56))
+#define LEPT_TAPE_PAYLOAD(w)          ((size_t)((w) & (((uint64_t)1 << 56) - 1)))
+
+void lept_tape_init(lept_tape* t) {
+	assert(t != NULL);
+	t->words = NULL;
+	t->size = t->capacity = 0;
+	t->strings = NULL;
+	t->string_size = t->string_capacity = 0;
+}
+
+void lept_tape_free(lept_tape* t) {
+	assert(t != NULL);
+	LEPT_FREE(LEPT_GLOBAL, t->words);
+	LEPT_FREE(LEPT_GLOBAL, t->strings);
+	lept_tape_init(t);
+}
+
+// ĩβn֣n2
+static uint64_t* lept_tape_push(lept_tape* t, size_t n) {
+	if (t->size + n > t->capacity) {
+		t->capacity = t->capacity ? t->capacity + t->capacity / 2 : 64;
+		t->words = (uint64_t*)LEPT_REALLOC(LEPT_GLOBAL, t->words, t->capacity * sizeof(uint64_t));
+	}
+	t->size += n;
+	return t->words + t->size - n;
+}
+
+static void lept_tape_string(lept_tape* t, const char* s, size_t len) {
+	size_t need = sizeof(size_t) + len + 1;
+	char* p;
+	if (t->string_size + need > t->string_capacity) {
+		t->string_capacity = t->string_capacity ? t->string_capacity + t->string_capacity / 2 : 256;
+		if (t->string_capacity < t->string_size + need)
+			t->string_capacity = t->string_size + need;
+		t->strings = (char*)LEPT_REALLOC(LEPT_GLOBAL, t->strings, t->string_capacity);
+	}
+	*lept_tape_push(t, 1) = LEPT_TAPE_WORD(LEPT_STRING, t->string_size);
+	p = t->strings + t->string_size;
+	memcpy(p, &len, sizeof(size_t));
+	memcpy(p + sizeof(size_t), s, len);
+	p[sizeof(size_t) + len] = '\0';
+	t->string_size += need;
+}
+
+static void lept_tape_number(lept_tape* t, double n) {
+	uint64_t* w = lept_tape_push(t, 2);
+	w[0] = LEPT_TAPE_WORD(LEPT_NUMBER, 0);
+	memcpy(&w[1], &n, sizeof(double));
+}
+
+// ʼһ/ʱּ֪һλã
+// д/ʹһջ*openջ
+static void lept_tape_open(lept_tape* t, lept_type type, size_t* open) {
+	uint64_t* w = lept_tape_push(t, 2);
+	w[0] = LEPT_TAPE_WORD(type, *open);
+	w[1] = 0;
+	*open = t->size - 2;
+}
+
+static void lept_tape_close(lept_tape* t, size_t count, size_t* open) {
+	uint64_t* w = t->words + *open;
+	*open = LEPT_TAPE_PAYLOAD(w[0]);
+	w[0] = LEPT_TAPE_WORD(LEPT_TAPE_TYPE(w[0]), t->size);
+	w[1] = count;
+}
+
+typedef struct {
+	lept_tape* t;
+	size_t open;
+} lept_tape_builder;
+
+static int lept_tape_on_null(void* user) {
+	*lept_tape_push(((lept_tape_builder*)user)->t, 1) = LEPT_TAPE_WORD(LEPT_NULL, 0);
+	return 1;
+}
+
+static int lept_tape_on_boolean(void* user, int b) {
+	*lept_tape_push(((lept_tape_builder*)user)->t, 1) = LEPT_TAPE_WORD(b ? LEPT_TRUE : LEPT_FALSE, 0);
+	return 1;
+}
+
+static int lept_tape_on_number(void* user, double n) {
+	lept_tape_number(((lept_tape_builder*)user)->t, n);
+	return 1;
+}
+
+static int lept_tape_on_string(void* user, const char* s, size_t len) {
+	lept_tape_string(((lept_tape_builder*)user)->t, s, len);
+	return 1;
+}
+
+static int lept_tape_on_start_array(void* user) {
+	lept_tape_builder* b = (lept_tape_builder*)user;
+	lept_tape_open(b->t, LEPT_ARRAY, &b->open);
+	return 1;
+}
+
+static int lept_tape_on_start_object(void* user) {
+	lept_tape_builder* b = (lept_tape_builder*)user;
+	lept_tape_open(b->t, LEPT_OBJECT, &b->open);
+	return 1;
+}
+
+static int lept_tape_on_end(void* user, size_t count) {
+	lept_tape_builder* b = (lept_tape_builder*)user;
+	lept_tape_close(b->t, count, &b->open);
+	return 1;
+}
+
+// ַһдȥ
+static const lept_sax_handler lept_tape_handler = {
+	lept_tape_on_null, lept_tape_on_boolean, lept_tape_on_number, lept_tape_on_string,
+	lept_tape_on_start_array, lept_tape_on_end, lept_tape_on_start_object, lept_tape_on_string, lept_tape_on_end
+};
+
+int lept_parse_tape(lept_tape* t, const char* json, size_t len) {
+	lept_context c;
+	lept_tape_builder b;
+	int ret;
+	assert(t != NULL && (json != NULL || len == 0));
+	t->size = t->string_size = 0;
+	b.t = t;
+	b.open = 0;
+	lept_context_init(&c, json, len);
+	if ((ret = lept_sax_root(&c, &lept_tape_handler, &b)) != LEPT_PARSE_OK)
+		t->size = t->string_size = 0;
+	return ret;
+}
+
+// /ʱд¿ͷһ㣬һԪضдٲϽλ
+void lept_tape_from_value(lept_tape* t, const lept_value* v) {
+	lept_walk w;
+	size_t open = 0;
+	assert(t != NULL && v != NULL);
+	t->size = t->string_size = 0;
+	lept_walk_init(&w, LEPT_GLOBAL);
+	while (v != NULL) {
+		LEPT_EXPAND(v);
+		switch (v->type) {
+		case LEPT_NUMBER: lept_tape_number(t, v->u.n); break;
+		case LEPT_STRING: lept_tape_string(t, LEPT_STR(v), LEPT_STR_LEN(v)); break;
+		case LEPT_ARRAY:
+		case LEPT_OBJECT:
+			lept_tape_open(t, v->type, &open);
+			lept_walk_push(&w, v);
+			break;
+		default: *lept_tape_push(t, 1) = LEPT_TAPE_WORD(v->type, 0); break;
+		}
+		// һҪдֵļд
+		for (v = NULL; v == NULL && w.top; ) {
+			lept_walk_entry* e = &w.e[w.top - 1];
+			const lept_value* x = e->v;
+			if (x->type == LEPT_ARRAY && e->i < x->u.a.size)
+				v = &x->u.a.e[e->i++];
+			else if (x->type == LEPT_OBJECT && e->i < x->u.o.size) {
+				lept_tape_string(t, LEPT_KEY(&x->u.o.m[e->i]), x->u.o.m[e->i].klen);
+				v = &x->u.o.m[e->i++].v;
+			}
+			else {
+				lept_tape_close(t, e->i, &open);
+				w.top--;
+			}
+		}
+	}
+	lept_walk_free(&w);
+}
+
+// tapeģͬ˳iһֱ
+void lept_tape_to_value(const lept_tape* t, size_t i, lept_value* v) {
+	lept_walk w;
+	size_t n;
+	assert(t != NULL && i < t->size && v != NULL);
+	lept_walk_init(&w, LEPT_GLOBAL);
+	while (v != NULL) {
+		lept_init(v);
+		v->type = LEPT_TAPE_TYPE(t->words[i]);
+		switch (v->type) {
+		case LEPT_NUMBER:
+			memcpy(&v->u.n, &t->words[i + 1], sizeof(double));
+			i += 2;
+			break;
+		case LEPT_STRING:
+			n = lept_tape_get_string_length(t, i);
+			memcpy(lept_string_buffer(NULL, v, n), lept_tape_get_string(t, i), n);
+			i++;
+			break;
+		case LEPT_ARRAY:
+			v->u.a.size = n = (size_t)t->words[i + 1];
+			v->u.a.e = n ? (lept_value*)LEPT_MALLOC(LEPT_GLOBAL, n * sizeof(lept_value)) : NULL;
+			lept_walk_push(&w, v);
+			i += 2;
+			break;
+		case LEPT_OBJECT:
+			// ͽʱһԱĶϹϣԱٽ
+			v->u.o.size = n = (size_t)t->words[i + 1];
+			v->u.o.m = n ? (lept_member*)LEPT_MALLOC(LEPT_GLOBAL, n * sizeof(lept_member) +
+				(n >= LEPT_OBJECT_INDEX_MIN ? lept_object_index_capacity(n) * sizeof(uint32_t) : 0)) : NULL;
+			lept_walk_push(&w, v);
+			i += 2;
+			break;
+		default:
+			i++;
+			break;
+		}
+		for (v = NULL; v == NULL && w.top; ) {
+			lept_walk_entry* e = &w.e[w.top - 1];
+			lept_value* x = (lept_value*)e->v;
+			if (x->type == LEPT_ARRAY && e->i < x->u.a.size)
+				v = &x->u.a.e[e->i++];
+			else if (x->type == LEPT_OBJECT && e->i < x->u.o.size) {
+				lept_member* m = &x->u.o.m[e->i++];
+				n = lept_tape_get_string_length(t, i);
+				memcpy(lept_key_buffer(NULL, m, n), lept_tape_get_string(t, i), n);
+				i++;
+				v = &m->v;
+			}
+			else {
+				if (x->type == LEPT_OBJECT && x->u.o.size >= LEPT_OBJECT_INDEX_MIN)
+					lept_object_index_build(x);
+				w.top--;
+			}
+		}
+	}
+	lept_walk_free(&w);
+}
+
+lept_type lept_tape_get_type(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size);
+	return LEPT_TAPE_TYPE(t->words[i]);
+}
+
+size_t lept_tape_next(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size);
+	switch (LEPT_TAPE_TYPE(t->words[i])) {
+	case LEPT_NUMBER: return i + 2;
+	case LEPT_ARRAY:
+	case LEPT_OBJECT: return LEPT_TAPE_PAYLOAD(t->words[i]);
+	default: return i + 1;
+	}
+}
+
+int lept_tape_get_boolean(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size);
+	assert(LEPT_TAPE_TYPE(t->words[i]) == LEPT_FALSE || LEPT_TAPE_TYPE(t->words[i]) == LEPT_TRUE);
+	return LEPT_TAPE_TYPE(t->words[i]) == LEPT_TRUE;
+}
+
+double lept_tape_get_number(const lept_tape* t, size_t i) {
+	double n;
+	assert(t != NULL && i < t->size && LEPT_TAPE_TYPE(t->words[i]) == LEPT_NUMBER);
+	memcpy(&n, &t->words[i + 1], sizeof(double));
+	return n;
+}
+
+const char* lept_tape_get_string(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TYPE(t->words[i]) == LEPT_STRING);
+	return t->strings + LEPT_TAPE_PAYLOAD(t->words[i]) + sizeof(size_t);
+}
+
+size_t lept_tape_get_string_length(const lept_tape* t, size_t i) {
+	size_t len;
+	assert(t != NULL && i < t->size && LEPT_TAPE_TYPE(t->words[i]) == LEPT_STRING);
+	memcpy(&len, t->strings + LEPT_TAPE_PAYLOAD(t->words[i]), sizeof(size_t));
+	return len;
+}
+
+size_t lept_tape_get_array_size(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TYPE(t->words[i]) == LEPT_ARRAY);
+	return (size_t)t->words[i + 1];
+}
+
+size_t lept_tape_get_array_element(const lept_tape* t, size_t i, size_t index) {
+	assert(index < lept_tape_get_array_size(t, i));
+	for (i += 2; index; index--)
+		i = lept_tape_next(t, i);
+	return i;
+}
+
+size_t lept_tape_get_object_size(const lept_tape* t, size_t i) {
+	assert(t != NULL && i < t->size && LEPT_TAPE_TYPE(t->words[i]) == LEPT_OBJECT);
+	return (size_t)t->words[i + 1];
+}
+
+// indexԱļ±ֵ꣬ڼ
+static size_t lept_tape_member(const lept_tape* t, size_t i, size_t index) {
+	assert(index < lept_tape_get_object_size(t, i));
+	for (i += 2; index; index--)
+		i = lept_tape_next(t, i + 1);
+	return i;
+}
+
+const char* lept_tape_get_object_key(const lept_tape* t, size_t i, size_t index) {
+	return lept_tape_get_string(t, lept_tape_member(t, i, index));
+}
+
+size_t lept_tape_get_object_key_length(const lept_tape* t, size_t i, size_t index) {
+	return lept_tape_get_string_length(t, lept_tape_member(t, i, index));
+}
+
+size_t lept_tape_get_object_value(const lept_tape* t, size_t i, size_t index) {
+	return lept_tape_member(t, i, index) + 1;
+}
+
+size_t lept_tape_find_object_value(const lept_tape* t, size_t i, const char* key, size_t klen) {
+	size_t n = lept_tape_get_object_size(t, i);
+	assert(key != NULL);
+	for (i += 2; n; n--) {
+		if (lept_tape_get_string_length(t, i) == klen && memcmp(lept_tape_get_string(t, i), key, klen) == 0)
+			return i + 1;
+		i = lept_tape_next(t, i + 1);
+	}
+	return LEPT_KEY_NOT_EXIST;
+}
+
+///!*******************************************************
+/*
+	Էֳικһֽڴͣһ鵽ٽŽ
+	Բõݹ½ĳһֽƽ״̬״̬lept_parser
+	ʱջĲֺlept_parseһԪءĳԱ˳ѹջϣ
+	ÿһ/Ҳջѹһlept_frame¼һϢ
+	ڽֵַԭ()Ҳʱջ
+	(lept_parser_finish)һַLEPT_EOFÿ״̬Ĵlept_parseβһ
+	е'\0'ֽһԴÿһִ󶼻ͬһλáͬһ뱨
+	ϵֵ˻ͣLEPT_PS_AFTER_VALUEιķǿհ׶LEPT_PARSE_ROOT_NOT_SINGULAR
+*/
+#define LEPT_EOF (-1)
+
+enum {
+	LEPT_PS_VALUE,          // ȴһֵǰпհ
+	LEPT_PS_ARRAY_FIRST,    // '['֮󣬵ȴһֵ']'
+	LEPT_PS_OBJECT_FIRST,   // '{'֮󣬵ȴһ'}'
+	LEPT_PS_KEY,            // ','֮󣬵ȴһ
+	LEPT_PS_COLON,          // ֮󣬵ȴ':'
+	LEPT_PS_AFTER_VALUE,    // ֵ֮󣬵ȴ','ţڸϵȴβ
+	LEPT_PS_LITERAL,        // null/true/falseliteralָʣҪƥַ
+	LEPT_PS_NUMBER,         // sub﷨λ
+	LEPT_PS_STRING,
+	LEPT_PS_ESCAPE,         // '\\'֮
+	LEPT_PS_HEX,            // \\u4λsubѾλ
+	LEPT_PS_SURROGATE_BACKSLASH, // ߴ֮󣬵ȴ'\\'
+	LEPT_PS_SURROGATE_U,    // ȴ'u'
+	LEPT_PS_HEX_LOW,        // ʹ4λ
+	LEPT_PS_DONE            // Ѿн(ret)ˣˣ붼
+};
+
+// ﷨λ
+enum {
+	LEPT_PN_MINUS,  // '-'֮Ҫһ
+	LEPT_PN_ZERO,   // ͷ'0'֮
+	LEPT_PN_INT,    // 
+	LEPT_PN_DOT,    // '.'֮Ҫһ
+	LEPT_PN_FRAC,   // С
+	LEPT_PN_E,      // 'e'֮
+	LEPT_PN_ESIGN,  // ָķ֮Ҫһ
+	LEPT_PN_EXP     // ָ
+};
+
+#define ISWHITESPACE(ch) ((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r')
+
+void lept_parser_init(lept_parser* p) {
+	assert(p != NULL);
+	p->stack = NULL;
+	p->size = p->top = p->peak = 0;
+	p->uses = 0;
+	p->frame = LEPT_FRAME_ROOT;
+	p->depth = 0;
+	p->max_depth = LEPT_PARSE_MAX_DEPTH;
+	p->intern = NULL;
+	p->state = LEPT_PS_VALUE;
+	p->ret = LEPT_PARSE_OK;
+	lept_init(&p->root);
+}
+
+// ͷŽһж
+static void lept_parser_discard(lept_parser* p, lept_context* c) {
+	lept_frame_discard(c, p->frame);
+	p->frame = LEPT_FRAME_ROOT;
+	lept_free(&p->root);
+	c->top = 0;
+}
+
+static int lept_parser_error(lept_parser* p, lept_context* c, int ret) {
+	lept_parser_discard(p, c);
+	p->state = LEPT_PS_DONE;
+	return p->ret = ret;
+}
+
+// һֵˣŵϻߵǰһ
+static void lept_parser_emit(lept_parser* p, lept_context* c, const lept_value* e) {
+	LEPT_STAT_ADD(values[e->type], 1);
+	p->state = LEPT_PS_AFTER_VALUE;
+	if (p->frame == LEPT_FRAME_ROOT)
+		p->root = *e;
+	else
+		lept_frame_append(c, p->frame, e);
+}
+
+static int lept_parser_open(lept_parser* p, lept_context* c, lept_type type) {
+	if (++p->depth > p->max_depth)
+		return lept_parser_error(p, c, LEPT_PARSE_DEPTH_EXCEEDED);
+	LEPT_STAT_MAX(max_depth, p->depth);
+	p->frame = lept_frame_push(c, p->frame, type);
+	p->state = type == LEPT_ARRAY ? LEPT_PS_ARRAY_FIRST : LEPT_PS_OBJECT_FIRST;
+	return LEPT_PARSE_OK;
+}
+
+// ˽ţһԪسΪһµֵһ
+static void lept_parser_close(lept_parser* p, lept_context* c) {
+	lept_value e;
+	p->depth--;
+	p->frame = lept_frame_close(c, p->frame, &e);
+	lept_parser_emit(p, c, &e);
+}
+
+// ֵԭջlept_parse_numberתlept_parseһ
+static int lept_parser_number(lept_parser* p, lept_context* c) {
+	lept_context t;
+	lept_value e;
+	int ret;
+	lept_context_init(&t, c->stack + p->head, c->top - p->head);
+	lept_init(&e);
+	LEPT_STAT_START(LEPT_PHASE_NUMBER);
+	ret = lept_parse_number(&t, &e);
+	LEPT_STAT_STOP(LEPT_PHASE_NUMBER);
+	LEPT_FREE(t.alloc, t.stack);
+	c->top = p->head;
+	if (ret == LEPT_PARSE_OK)
+		lept_parser_emit(p, c, &e);
+	return ret;
+}
+
+// ַˣջڶﲢһûмʱǼֵ
+static void lept_parser_string(lept_parser* p, lept_context* c) {
+	size_t len = c->top - p->head;
+	const char* s = (const char*)lept_context_pop(c, len); // ֮ݻڣ䲻ᶯջ
+	lept_frame* f = p->frame == LEPT_FRAME_ROOT ? NULL : LEPT_FRAME(c, p->frame);
+	if (f != NULL && f->type == LEPT_OBJECT && !f->key) {
+		lept_context_key(c, &f->m, s, len);
+		f->key = 1;
+		p->state = LEPT_PS_COLON;
+	}
+	else {
+		lept_value e;
+		lept_init(&e);
+		LEPT_COPY(lept_string_buffer(c, &e, len), s, len);
+		lept_parser_emit(p, c, &e);
+	}
+}
+
+static int lept_hex_digit(int ch) {
+	if (ch >= '0' && ch <= '9') return ch - '0';
+	if (ch >= 'A' && ch <= 'F') return ch - ('A' - 10);
+	if (ch >= 'a' && ch <= 'f') return ch - ('a' - 10);
+	return -1;
+}
+
+// eofʾ[s, end)֮ͽˣʱsҪԽendһֽ
+static int lept_parser_run(lept_parser* p, lept_context* c, const char* s, const char* end, int eof) {
+	while (s < end || (eof && p->state != LEPT_PS_DONE)) {
+		int ch = s < end ? (unsigned char)*s : LEPT_EOF;
+		int ret, d;
+		switch (p->state) {
+		case LEPT_PS_VALUE:
+		case LEPT_PS_ARRAY_FIRST:
+			if (ISWHITESPACE(ch)) {
+				s++;
+				break;
+			}
+			if (ch == ']' && p->state == LEPT_PS_ARRAY_FIRST) {
+				s++;
+				lept_parser_close(p, c);
+				break;
+			}
+			s++;
+			switch (ch) {
+			case 'n': p->literal = "ull";  p->sub = LEPT_NULL;  p->state = LEPT_PS_LITERAL; break;
+			case 't': p->literal = "rue";  p->sub = LEPT_TRUE;  p->state = LEPT_PS_LITERAL; break;
+			case 'f': p->literal = "alse"; p->sub = LEPT_FALSE; p->state = LEPT_PS_LITERAL; break;
+			case '"':
+				p->head = c->top;
+				p->state = LEPT_PS_STRING;
+				break;
+			case '[':
+			case '{':
+				if ((ret = lept_parser_open(p, c, ch == '[' ? LEPT_ARRAY : LEPT_OBJECT)) != LEPT_PARSE_OK)
+					return ret;
+				break;
+			case LEPT_EOF: return lept_parser_error(p, c, LEPT_PARSE_EXPECT_VALUE);
+			default:
+				if (ch != '-' && !ISDIGIT(ch))
+					return lept_parser_error(p, c, LEPT_PARSE_INVALID_VALUE);
+				p->head = c->top;
+				PUTC(c, ch);
+				p->sub = ch == '-' ? LEPT_PN_MINUS : ch == '0' ? LEPT_PN_ZERO : LEPT_PN_INT;
+				p->state = LEPT_PS_NUMBER;
+			}
+			break;
+		case LEPT_PS_OBJECT_FIRST:
+		case LEPT_PS_KEY:
+			if (ISWHITESPACE(ch)) {
+				s++;
+				break;
+			}
+			if (ch == '}' && p->state == LEPT_PS_OBJECT_FIRST) {
+				s++;
+				lept_parser_close(p, c);
+				break;
+			}
+			if (ch != '"')
+				return lept_parser_error(p, c, LEPT_PARSE_MISS_KEY);
+			s++;
+			p->head = c->top;
+			p->state = LEPT_PS_STRING;
+			break;
+		case LEPT_PS_COLON:
+			if (ISWHITESPACE(ch)) {
+				s++;
+				break;
+			}
+			if (ch != ':')
+				return lept_parser_error(p, c, LEPT_PARSE_MISS_COLON);
+			s++;
+			p->state = LEPT_PS_VALUE;
+			break;
+		case LEPT_PS_AFTER_VALUE:
+			if (ISWHITESPACE(ch)) {
+				s++;
+				break;
+			}
+			s++;
+			if (p->frame == LEPT_FRAME_ROOT) {
+				if (ch != LEPT_EOF)
+					return lept_parser_error(p, c, LEPT_PARSE_ROOT_NOT_SINGULAR);
+				p->state = LEPT_PS_DONE;
+				p->ret = LEPT_PARSE_OK;
+			}
+			else if (LEPT_FRAME(c, p->frame)->type == LEPT_ARRAY) {
+				if (ch == ',')
+					p->state = LEPT_PS_VALUE;
+				else if (ch == ']')
+					lept_parser_close(p, c);
+				else
+					return lept_parser_error(p, c, LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET);
+			}
+			else {
+				if (ch == ',')
+					p->state = LEPT_PS_KEY;
+				else if (ch == '}')
+					lept_parser_close(p, c);
+				else
+					return lept_parser_error(p, c, LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET);
+			}
+			break;
+		case LEPT_PS_LITERAL:
+			if (ch != *p->literal)
+				return lept_parser_error(p, c, LEPT_PARSE_INVALID_VALUE);
+			s++;
+			if (*++p->literal == '\0') {
+				lept_value e;
+				lept_init(&e);
+				e.type = (lept_type)p->sub;
+				lept_parser_emit(p, c, &e);
+			}
+			break;
+		case LEPT_PS_NUMBER: {
+			int next = -1; // -1ʾ
+			switch (p->sub) {
+			case LEPT_PN_MINUS:
+				if (!ISDIGIT(ch))
+					return lept_parser_error(p, c, LEPT_PARSE_INVALID_VALUE);
+				next = ch == '0' ? LEPT_PN_ZERO : LEPT_PN_INT;
+				break;
+			case LEPT_PN_INT:
+				if (ISDIGIT(ch)) {
+					next = LEPT_PN_INT;
+					break;
+				}
+				/* fall through */
+			case LEPT_PN_ZERO:
+				if (ch == '.')
+					next = LEPT_PN_DOT;
+				else if (ch == 'e' || ch == 'E')
+					next = LEPT_PN_E;
+				break;
+			case LEPT_PN_DOT:
+				if (!ISDIGIT(ch))
+					return lept_parser_error(p, c, LEPT_PARSE_INVALID_VALUE);
+				next = LEPT_PN_FRAC;
+				break;
+			case LEPT_PN_FRAC:
+				if (ISDIGIT(ch))
+					next = LEPT_PN_FRAC;
+				else if (ch == 'e' || ch == 'E')
+					next = LEPT_PN_E;
+				break;
+			case LEPT_PN_E:
+				if (ch == '+' || ch == '-')
+					next = LEPT_PN_ESIGN;
+				else if (ISDIGIT(ch))
+					next = LEPT_PN_EXP;
+				else
+					return lept_parser_error(p, c, LEPT_PARSE_INVALID_VALUE);
+				break;
+			case LEPT_PN_ESIGN:
+				if (!ISDIGIT(ch))
+					return lept_parser_error(p, c, LEPT_PARSE_INVALID_VALUE);
+				next = LEPT_PN_EXP;
+				break;
+			case LEPT_PN_EXP:
+				if (ISDIGIT(ch))
+					next = LEPT_PN_EXP;
+				break;
+			}
+			if (next >= 0) {
+				PUTC(c, ch);
+				p->sub = next;
+				s++;
+			}
+			else if ((ret = lept_parser_number(p, c)) != LEPT_PARSE_OK) // ǰַ֣һ״̬
+				return lept_parser_error(p, c, ret);
 			break;
 		}
-		if ((ret = lept_parse_string_raw(c, &str, &m.klen)) != LEPT_PARSE_OK) break;
-		memcpy(m.k = (char*)malloc(m.klen + 1), str, m.klen + 1);
-		/* հ + ð + հ */
-		lept_parse_whitespace(c);
-		if (*c->json != ':') {
-			ret = LEPT_PARSE_MISS_COLON;
+		case LEPT_PS_STRING: {
+			// ַͨһԿ
+			const char* q = s;
+			while (q < end && *q != '"' && *q != '\\' && (unsigned char)*q >= 0x20)
+				q++;
+			if (q != s) {
+				memcpy(lept_context_push(c, q - s), s, q - s);
+				s = q;
+				break;
+			}
+			s++;
+			if (ch == '"')
+				lept_parser_string(p, c);
+			else if (ch == '\\')
+				p->state = LEPT_PS_ESCAPE;
+			else if (ch == LEPT_EOF)
+				return lept_parser_error(p, c, LEPT_PARSE_MISS_QUOTATION_MARK);
+			else
+				return lept_parser_error(p, c, LEPT_PARSE_INVALID_STRING_CHAR);
 			break;
 		}
-		c->json++;
-		lept_parse_whitespace(c);
-
-		// Աֵ
-		if ((ret = lept_parse_value(c, &m.v)) != LEPT_PARSE_OK) break;
-		memcpy(lept_context_push(c, sizeof(lept_member)), &m, sizeof(lept_member));
-		size++;
-		m.k = NULL; // ΪԴѾƵջˣmһʱԱ׼һ
-		
-		// parse ո [',' | '}'] ո 
-		lept_parse_whitespace(c);
-		if (*c->json == ',') {
-			c->json++;
-			lept_parse_whitespace(c);
-		} else if (*c->json == '}') {
-			size_t s = sizeof(lept_member) * size;
-			c->json++;
-			v->type = LEPT_OBJECT;
-			v->u.o.size = size;
-			memcpy(v->u.o.m = (lept_member*)malloc(s), lept_context_pop(c, s), s);
-			return LEPT_PARSE_OK;
-		} else {
-			ret = LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+		case LEPT_PS_ESCAPE:
+			s++;
+			if (ch == 'u') {
+				p->u = 0;
+				p->sub = 0;
+				p->state = LEPT_PS_HEX;
+			}
+			else {
+				// ַת彻lept_parse_escapeʱյ
+				char b = (char)ch;
+				const char* e = &b;
+				char buf[4];
+				int n;
+				if ((ret = lept_parse_escape(&e, ch == LEPT_EOF ? e : e + 1, buf, &n)) != LEPT_PARSE_OK)
+					return lept_parser_error(p, c, ret);
+				PUTC(c, buf[0]);
+				p->state = LEPT_PS_STRING;
+			}
+			break;
+		case LEPT_PS_HEX:
+		case LEPT_PS_HEX_LOW:
+			if ((d = lept_hex_digit(ch)) < 0)
+				return lept_parser_error(p, c, LEPT_PARSE_INVALID_UNICODE_HEX);
+			s++;
+			if (p->state == LEPT_PS_HEX)
+				p->u = (p->u << 4) | d;
+			else
+				p->u2 = (p->u2 << 4) | d;
+			if (++p->sub < 4)
+				break;
+			if (p->state == LEPT_PS_HEX && p->u >= 0xD800 && p->u <= 0xDBFF) {
+				p->state = LEPT_PS_SURROGATE_BACKSLASH;
+				break;
+			}
+			if (p->state == LEPT_PS_HEX_LOW) {
+				if (p->u2 < 0xDC00 || p->u2 > 0xDFFF)
+					return lept_parser_error(p, c, LEPT_PARSE_INVALID_UNICODE_SURROGATE);
+				p->u = (((p->u - 0xD800) << 10) | (p->u2 - 0xDC00)) + 0x10000;
+			}
+			{
+				char buf[4];
+				int n = lept_encode_utf8(buf, p->u);
+				memcpy(lept_context_push(c, n), buf, n);
+			}
+			p->state = LEPT_PS_STRING;
 			break;
+		case LEPT_PS_SURROGATE_BACKSLASH:
+			if (ch != '\\')
+				return lept_parser_error(p, c, LEPT_PARSE_INVALID_UNICODE_SURROGATE);
+			s++;
+			p->state = LEPT_PS_SURROGATE_U;
+			break;
+		case LEPT_PS_SURROGATE_U:
+			if (ch != 'u')
+				return lept_parser_error(p, c, LEPT_PARSE_INVALID_UNICODE_SURROGATE);
+			s++;
+			p->u2 = 0;
+			p->sub = 0;
+			p->state = LEPT_PS_HEX_LOW;
+			break;
+		case LEPT_PS_DONE:
+			return p->ret;
 		}
 	}
+	return p->state == LEPT_PS_DONE ? p->ret : LEPT_PARSE_OK;
+}
 
-	// ͷʱԱֵvalueԱָ룬ͷ
-	free(m.k);
-	// ΪջϵԴѾƵ˽УͷջϵԴ
-	for (i = 0; i < size; i++) {
-		lept_member* m = (lept_member*)lept_context_pop(c, sizeof(lept_member));
-		free(m->k);
-		lept_free(&m->v);
-	}
-	v->type = LEPT_NULL;
+static int lept_parser_step(lept_parser* p, const char* buf, size_t len, int eof) {
+	lept_context c;
+	int ret;
+	if (p->state == LEPT_PS_DONE)
+		return p->ret;
+	// lept_contextջ֮ٴȥ
+	lept_context_init(&c, buf, len);
+	c.stack = p->stack;
+	c.size = p->size;
+	c.top = p->top;
+	c.peak = p->peak;
+	c.intern = p->intern;
+	LEPT_STAT_START(LEPT_PHASE_PARSE);
+	ret = lept_parser_run(p, &c, buf, buf + len, eof);
+	LEPT_STAT_STOP(LEPT_PHASE_PARSE);
+	LEPT_STAT_ADD(bytes, len);
+	p->stack = c.stack;
+	p->size = c.size;
+	p->top = c.top;
+	p->peak = c.peak;
 	return ret;
 }
 
+int lept_parser_feed(lept_parser* p, const char* buf, size_t len) {
+	assert(p != NULL && (buf != NULL || len == 0));
+	return lept_parser_step(p, buf, len, 0);
+}
 
-static int lept_parse_value(lept_context* c, lept_value* v) {
-	switch (*c->json) {
-	case 'n':  return lept_parse_null(c, v);
-	case '[':  return lept_parse_array(c, v);
-	case 't': return lept_parse_true(c, v);
-	case 'f': return lept_parse_false(c, v);
-	case '\"': return lept_parse_string(c, v);
-	case '{': return lept_parse_object(c, v);
-	case '\0': return LEPT_PARSE_EXPECT_VALUE;
-	default:   return lept_parse_number(c, v);
+int lept_parser_finish(lept_parser* p, lept_value* v) {
+	static const char none[1] = { 0 }; // ʱsԽβһֽ
+	int ret;
+	assert(p != NULL && v != NULL);
+	ret = lept_parser_step(p, none, 0, 1);
+	lept_init(v);
+	if (ret == LEPT_PARSE_OK) {
+		*v = p->root;
+		lept_init(&p->root);
 	}
+	// ԽŽһĵջŸ
+	p->frame = LEPT_FRAME_ROOT;
+	p->depth = 0;
+	p->top = 0;
+	p->state = LEPT_PS_VALUE;
+	p->ret = LEPT_PARSE_OK;
+	lept_scratch_shrink(&p->stack, &p->size, &p->peak, &p->uses);
+	return ret;
 }
 
-// json-text  : ws + value + ws
-int lept_parse(lept_value* v, const char* json) {
+int lept_parser_parse(lept_parser* p, lept_value* v, const char* json, size_t len) {
 	lept_context c;
-	assert(v != NULL);
-	c.json = json;
-	c.stack = NULL;        /* <- */
-	c.size = c.top = 0;    /* <- */
-	lept_init(v);
+	int ret;
+	assert(p != NULL && (json != NULL || len == 0));
+	assert(p->state == LEPT_PS_VALUE && p->top == 0); // feedһʱ
+	lept_context_init(&c, json, len);
+	c.stack = p->stack;
+	c.size = p->size;
+	c.peak = p->peak;
+	c.max_depth = p->max_depth;
+	c.intern = p->intern;
+	ret = lept_parse_root(&c, v);
+	p->stack = c.stack;
+	p->size = c.size;
+	p->peak = c.peak;
+	lept_scratch_shrink(&p->stack, &p->size, &p->peak, &p->uses);
+	return ret;
+}
 
-	lept_parse_whitespace(&c);
+void lept_parser_free(lept_parser* p) {
+	lept_context c;
+	assert(p != NULL);
+	lept_context_init(&c, NULL, 0);
+	c.stack = p->stack;
+	c.top = p->top;
+	c.intern = p->intern;
+	if (p->state != LEPT_PS_DONE)
+		lept_parser_discard(p, &c);
+	lept_free(&p->root);
+	LEPT_FREE(LEPT_GLOBAL, p->stack);
+	lept_parser_init(p);
+}
 
-	int ret = lept_parse_value(&c, v);
-	// ǲǳɹҪͷԴ
-	if (ret != LEPT_PARSE_OK) {
-		free(c.stack);
-		return ret;
-	} else {
-		lept_parse_whitespace(&c);
-		if (c.json[0] == '\0') {
-			free(c.stack);
-			return LEPT_PARSE_OK;
-		} else {
-			free(c.stack);
-			return LEPT_PARSE_ROOT_NOT_SINGULAR;
-		}	
+///!*************************NDJSONн******************************
+/*
+	ÿһĵгɴԼLEPT_NDJSON_BATCH_SIZEֽڵһһ
+	߳ÿһԼlept_parserʱջڸ֮临á
+	orderedʱȴǰٰ˳ûص
+*/
+#ifndef LEPT_NDJSON_BATCH_SIZE
+#define LEPT_NDJSON_BATCH_SIZE (256 * 1024)
+#endif
+
+// LEPT_NO_THREADSֻڵõ߳ǿղ
+#if defined(LEPT_NO_THREADS)
+typedef int lept_mutex;
+typedef int lept_cond;
+#define lept_mutex_init(m)      ((void)0)
+#define lept_mutex_destroy(m)   ((void)0)
+#define lept_mutex_lock(m)      ((void)0)
+#define lept_mutex_unlock(m)    ((void)0)
+#define lept_cond_init(cv)      ((void)0)
+#define lept_cond_destroy(cv)   ((void)0)
+#define lept_cond_wait(cv, m)   ((void)0)
+#define lept_cond_broadcast(cv) ((void)0)
+#elif defined(_WIN32)
+typedef HANDLE lept_thread;
+typedef CRITICAL_SECTION lept_mutex;
+typedef CONDITION_VARIABLE lept_cond;
+#define lept_mutex_init(m)      InitializeCriticalSection(m)
+#define lept_mutex_destroy(m)   DeleteCriticalSection(m)
+#define lept_mutex_lock(m)      EnterCriticalSection(m)
+#define lept_mutex_unlock(m)    LeaveCriticalSection(m)
+#define lept_cond_init(cv)      InitializeConditionVariable(cv)
+#define lept_cond_destroy(cv)   ((void)0)
+#define lept_cond_wait(cv, m)   SleepConditionVariableCS(cv, m, INFINITE)
+#define lept_cond_broadcast(cv) WakeAllConditionVariable(cv)
+#else
+typedef pthread_t lept_thread;
+typedef pthread_mutex_t lept_mutex;
+typedef pthread_cond_t lept_cond;
+#define lept_mutex_init(m)      pthread_mutex_init(m, NULL)
+#define lept_mutex_destroy(m)   pthread_mutex_destroy(m)
+#define lept_mutex_lock(m)      pthread_mutex_lock(m)
+#define lept_mutex_unlock(m)    pthread_mutex_unlock(m)
+#define lept_cond_init(cv)      pthread_cond_init(cv, NULL)
+#define lept_cond_destroy(cv)   pthread_cond_destroy(cv)
+#define lept_cond_wait(cv, m)   pthread_cond_wait(cv, m)
+#define lept_cond_broadcast(cv) pthread_cond_broadcast(cv)
+#endif
+
+typedef struct {
+	const char* json;
+	const char* end;
+	const char* next;  // һʼλ
+	size_t batch;      // һ
+	size_t turn;       // orderedʱֵһ
+	int ordered, stop;
+	lept_record_func record;
+	void* user;
+	lept_mutex lock;
+	lept_cond cond;
+#if defined(LEPT_STATS)
+	lept_stats stats; // ̵߳ͳƼһ
+#endif
+} lept_ndjson_job;
+
+typedef struct {
+	size_t offset;
+	int ret;
+	lept_value v;
+} lept_ndjson_result;
+
+static void lept_ndjson_worker(lept_ndjson_job* j) {
+	lept_parser p;
+	lept_ndjson_result* r = NULL;
+	lept_value v;
+	const char *b, *e, *q, *s, *line;
+	size_t i, n, cap = 0, seq;
+	int ret, stopped = 0;
+	lept_parser_init(&p);
+	while (!stopped) {
+		// һβ뵽еĺ
+		lept_mutex_lock(&j->lock);
+		if (j->stop || j->next == j->end) {
+			lept_mutex_unlock(&j->lock);
+			break;
+		}
+		b = j->next;
+		e = j->end;
+		if ((size_t)(e - b) > LEPT_NDJSON_BATCH_SIZE && (q = (const char*)memchr(b + LEPT_NDJSON_BATCH_SIZE - 1, '\n', e - b - LEPT_NDJSON_BATCH_SIZE + 1)) != NULL)
+			e = q + 1;
+		j->next = e;
+		seq = j->batch++;
+		lept_mutex_unlock(&j->lock);
+
+		for (n = 0, line = b; line != e && !stopped; line = q) {
+			q = (const char*)memchr(line, '\n', e - line);
+			q = q ? q + 1 : e;
+			for (s = line; s != q && (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n'); s++)
+				;
+			if (s == q) // 
+				continue;
+			if (!j->ordered) {
+				ret = lept_parser_parse(&p, &v, line, q - line);
+				if (!j->record(j->user, line - j->json, ret, &v))
+					stopped = 1;
+				lept_free(&v);
+				continue;
+			}
+			if (n == cap) {
+				cap = cap ? cap + cap / 2 : 256;
+				r = (lept_ndjson_result*)LEPT_REALLOC(LEPT_GLOBAL, r, cap * sizeof(lept_ndjson_result));
+			}
+			r[n].offset = line - j->json;
+			r[n].ret = lept_parser_parse(&p, &r[n].v, line, q - line);
+			n++;
+		}
+
+		if (j->ordered) {
+			// ǰ꣬߳ʱԽŽ
+			lept_mutex_lock(&j->lock);
+			while (j->turn != seq && !j->stop)
+				lept_cond_wait(&j->cond, &j->lock);
+			stopped = j->stop;
+			lept_mutex_unlock(&j->lock);
+			for (i = 0; i < n; i++) {
+				if (!stopped && !j->record(j->user, r[i].offset, r[i].ret, &r[i].v))
+					stopped = 1;
+				lept_free(&r[i].v);
+			}
+		}
+		lept_mutex_lock(&j->lock);
+		if (stopped)
+			j->stop = 1;
+		j->turn++;
+		lept_cond_broadcast(&j->cond);
+		lept_mutex_unlock(&j->lock);
+	}
+	LEPT_FREE(LEPT_GLOBAL, r);
+	lept_parser_free(&p);
+}
+
+#if !defined(LEPT_NO_THREADS)
+// ֮߳̽ǰԼͳƽõ߳
+static void lept_ndjson_stats(lept_ndjson_job* j) {
+#if defined(LEPT_STATS)
+	// ߳ϾͽˣȰѾܵļӵԼϣȥ
+	lept_mutex_lock(&j->lock);
+	lept_stats_merge(&j->stats);
+	lept_stats_get(&j->stats);
+	lept_mutex_unlock(&j->lock);
+#else
+	(void)j;
+#endif
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI lept_ndjson_thread(LPVOID arg) {
+	lept_ndjson_worker((lept_ndjson_job*)arg);
+	lept_ndjson_stats((lept_ndjson_job*)arg);
+	return 0;
+}
+#else
+static void* lept_ndjson_thread(void* arg) {
+	lept_ndjson_worker((lept_ndjson_job*)arg);
+	lept_ndjson_stats((lept_ndjson_job*)arg);
+	return NULL;
+}
+#endif
+
+static int lept_cpu_count() {
+#if defined(_WIN32)
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return (int)si.dwNumberOfProcessors;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#endif
+}
+#endif
+
+int lept_parse_ndjson(const char* json, size_t len, int threads, int ordered, lept_record_func record, void* user) {
+	lept_ndjson_job j;
+#if !defined(LEPT_NO_THREADS)
+	lept_thread* t = NULL;
+	int i, started = 0;
+#endif
+	assert((json != NULL || len == 0) && record != NULL);
+	j.json = j.next = json;
+	j.end = len ? json + len : json;
+	j.batch = j.turn = 0;
+	j.ordered = ordered;
+	j.stop = 0;
+	j.record = record;
+	j.user = user;
+	lept_mutex_init(&j.lock);
+	lept_cond_init(&j.cond);
+#if defined(LEPT_STATS)
+	memset(&j.stats, 0, sizeof(j.stats));
+#endif
+	// ʱûѡSIMDʵֵʱѡã߳̾ͲͬʱȥдǼָ
+	lept_simd_select();
+#if !defined(LEPT_NO_THREADS)
+	if (threads <= 0)
+		threads = lept_cpu_count();
+	// õ߳Ҳһ߳̾һ
+	if (threads > 1 && (t = (lept_thread*)LEPT_MALLOC(LEPT_GLOBAL, (threads - 1) * sizeof(lept_thread))) != NULL)
+		for (i = 0; i < threads - 1; i++) {
+#if defined(_WIN32)
+			if ((t[started] = CreateThread(NULL, 0, lept_ndjson_thread, &j, 0, NULL)) != NULL)
+				started++;
+#else
+			if (pthread_create(&t[started], NULL, lept_ndjson_thread, &j) == 0)
+				started++;
+#endif
+		}
+#else
+	(void)threads;
+#endif
+	lept_ndjson_worker(&j);
+#if !defined(LEPT_NO_THREADS)
+	for (i = 0; i < started; i++) {
+#if defined(_WIN32)
+		WaitForSingleObject(t[i], INFINITE);
+		CloseHandle(t[i]);
+#else
+		pthread_join(t[i], NULL);
+#endif
 	}
+	LEPT_FREE(LEPT_GLOBAL, t);
+#endif
+#if defined(LEPT_STATS)
+	lept_stats_merge(&j.stats);
+#endif
+	lept_cond_destroy(&j.cond);
+	lept_mutex_destroy(&j.lock);
+	return j.stop ? LEPT_PARSE_ABORTED : LEPT_PARSE_OK;
+}
 
+int lept_parse_ndjson_file(const char* path, int threads, int ordered, lept_record_func record, void* user) {
+	lept_mapping m;
+	int ret;
+	assert(path != NULL && record != NULL);
+	if ((ret = lept_map_file(&m, path)) != LEPT_PARSE_OK)
+		return ret;
+	ret = lept_parse_ndjson((const char*)m.map, m.len, threads, ordered, record, user);
+	lept_unmap_file(&m);
+	return ret;
 }
 
 // ȡ͵ĺ
@@ -521,119 +4147,369 @@ lept_type lept_get_type(const lept_value* v) {
 // 
 #define PUTS(c, s, len) memcpy(lept_context_push(c, len), s, len)
 
-static void lept_stringify_string(lept_context* c, const char* s, size_t len) {
+///!*************************doubleתַ******************************
+/*
+	Grisu2㷨ܹȷԭ()ʮ
+	https://www.cs.tufts.edu/~nr/cs257/archive/florian-loitsch/printf.pdf
+	һ64λβӶָԶ帡(diy_fp)v±߽һ10ݣ
+	䵽һλֵķΧȻڱ߽֮ھٵ
+*/
+typedef struct {
+	uint64_t f;
+	int e;
+} lept_diy_fp;
+
+#define LEPT_DP_SIGNIFICAND_MASK (((uint64_t)1 << 52) - 1)
+#define LEPT_DP_HIDDEN_BIT ((uint64_t)1 << 52)
+#define LEPT_DP_EXPONENT_BIAS (0x3FF + 52)
+
+static lept_diy_fp lept_diy_fp_make(uint64_t f, int e) {
+	lept_diy_fp r;
+	r.f = f;
+	r.e = e;
+	return r;
+}
+
+// 128λ˷ȡ64λԵλ
+static lept_diy_fp lept_diy_fp_mul(lept_diy_fp a, lept_diy_fp b) {
+	uint64_t hi, lo;
+	lept_mul128(a.f, b.f, &hi, &lo);
+	return lept_diy_fp_make(hi + (lo >> 63), a.e + b.e + 64);
+}
+
+static lept_diy_fp lept_diy_fp_normalize(lept_diy_fp a) {
+	int s = lept_clz64(a.f);
+	return lept_diy_fp_make(a.f << s, a.e - s);
+}
+
+// v±߽m-m+֮ߵָͬ
+static void lept_normalized_boundaries(lept_diy_fp v, lept_diy_fp* minus, lept_diy_fp* plus) {
+	lept_diy_fp pl = lept_diy_fp_normalize(lept_diy_fp_make((v.f << 1) + 1, v.e - 1));
+	lept_diy_fp mi = (v.f == LEPT_DP_HIDDEN_BIT) ?
+		lept_diy_fp_make((v.f << 2) - 1, v.e - 2) : lept_diy_fp_make((v.f << 1) - 1, v.e - 1);
+	mi.f <<= mi.e - pl.e;
+	mi.e = pl.e;
+	*plus = pl;
+	*minus = mi;
+}
+
+// ѡһ10^-Kʹóָ֮[-60, -32]
+static lept_diy_fp lept_cached_power(int e, int* K) {
+	double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int k = (int)dk;
+	unsigned index;
+	if (dk - k > 0.0)
+		k++;
+	index = (unsigned)((k >> 3) + 1);
+	*K = -(-348 + (int)(index * 8));
+	return lept_diy_fp_make(lept_cached_pow_f[index], lept_cached_pow_e[index]);
+}
+
+static const uint64_t lept_pow10_u64[] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+	10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+	1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// һλµýӽʵֵ
+static void lept_grisu_round(char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+	while (rest < wp_w && delta - rest >= ten_kappa &&
+		(rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+		buffer[len - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+static int lept_count_digits(uint32_t n) {
+	int i = 1;
+	while (i < 10 && n >= (uint32_t)lept_pow10_u64[i])
+		i++;
+	return i;
+}
+
+static void lept_digit_gen(lept_diy_fp w, lept_diy_fp mp, uint64_t delta, char* buffer, int* len, int* K) {
+	const lept_diy_fp one = lept_diy_fp_make((uint64_t)1 << -mp.e, mp.e);
+	const uint64_t wp_w = mp.f - w.f;
+	uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+	uint64_t p2 = mp.f & (one.f - 1);
+	int kappa = lept_count_digits(p1);
+	*len = 0;
+	// 
+	while (kappa > 0) {
+		uint32_t d = p1 / (uint32_t)lept_pow10_u64[kappa - 1];
+		uint64_t tmp;
+		p1 %= (uint32_t)lept_pow10_u64[kappa - 1];
+		if (d || *len)
+			buffer[(*len)++] = (char)('0' + d);
+		kappa--;
+		tmp = ((uint64_t)p1 << -one.e) + p2;
+		if (tmp <= delta) {
+			*K += kappa;
+			lept_grisu_round(buffer, *len, delta, tmp, lept_pow10_u64[kappa] << -one.e, wp_w);
+			return;
+		}
+	}
+	// С
+	for (;;) {
+		char d;
+		p2 *= 10;
+		delta *= 10;
+		d = (char)(p2 >> -one.e);
+		if (d || *len)
+			buffer[(*len)++] = (char)('0' + d);
+		p2 &= one.f - 1;
+		kappa--;
+		if (p2 < delta) {
+			*K += kappa;
+			lept_grisu_round(buffer, *len, delta, p2, one.f, -kappa < 20 ? wp_w * lept_pow10_u64[-kappa] : 0);
+			return;
+		}
+	}
+}
+
+// doubleַŵbufferУֵ buffer * 10^K
+static void lept_grisu2(double value, char* buffer, int* len, int* K) {
+	uint64_t bits;
+	lept_diy_fp v, w_m, w_p, c_mk, W, Wp, Wm;
+	int biased_e;
+	memcpy(&bits, &value, sizeof(bits));
+	biased_e = (int)((bits >> 52) & 0x7FF);
+	if (biased_e != 0)
+		v = lept_diy_fp_make((bits & LEPT_DP_SIGNIFICAND_MASK) + LEPT_DP_HIDDEN_BIT, biased_e - LEPT_DP_EXPONENT_BIAS);
+	else
+		v = lept_diy_fp_make(bits & LEPT_DP_SIGNIFICAND_MASK, 1 - LEPT_DP_EXPONENT_BIAS);
+	lept_normalized_boundaries(v, &w_m, &w_p);
+	c_mk = lept_cached_power(w_p.e, K);
+	W = lept_diy_fp_mul(lept_diy_fp_normalize(v), c_mk);
+	Wp = lept_diy_fp_mul(w_p, c_mk);
+	Wm = lept_diy_fp_mul(w_m, c_mk);
+	Wm.f++;
+	Wp.f--;
+	lept_digit_gen(W, Wp, Wp.f - Wm.f, buffer, len, K);
+}
+
+// ޷תַس
+static int lept_utoa(uint64_t u, char* buffer) {
+	char tmp[20];
+	int n = 0, i;
+	do {
+		tmp[n++] = (char)('0' + u % 10);
+		u /= 10;
+	} while (u);
+	for (i = 0; i < n; i++)
+		buffer[i] = tmp[n - 1 - i];
+	return n;
+}
+
+/*
+	doubleдbuffer(25ֽ)سȣд'\0'
+	ʽ"%.17g"һʮָ[-4, 17)֮öʾ"1.5e+20"Ŀѧ
+	ֻܹԭͬһdoubleٵ֣Һlocale޹
+*/
+static int lept_dtoa(double value, char* buffer) {
+	char digits[20];
+	char* p = buffer;
+	int n, K, kk, i;
+	// NaNǺϷjson֮ǰһԭ
+	if (value != value || value - value != 0)
+		return sprintf(buffer, "%.17g", value);
+	if (value < 0 || (value == 0 && 1 / value < 0)) {
+		*p++ = '-';
+		value = -value;
+	}
+	// Ŀ·2^53ڵԾȷʾ
+	if (value < 9007199254740992.0 && value == (double)(uint64_t)value)
+		return (int)(p - buffer) + lept_utoa((uint64_t)value, p);
+
+	lept_grisu2(value, digits, &n, &K);
+	while (n > 1 && digits[n - 1] == '0') {
+		n--;
+		K++;
+	}
+	kk = n + K; // ֵ 0.digits * 10^kk
+	if (kk - 1 < -4 || kk - 1 >= 17) {
+		// ѧ d.ddde+XXָλ
+		int e = kk - 1;
+		*p++ = digits[0];
+		if (n > 1) {
+			*p++ = '.';
+			memcpy(p, digits + 1, n - 1);
+			p += n - 1;
+		}
+		*p++ = 'e';
+		*p++ = e < 0 ? '-' : '+';
+		if (e < 0)
+			e = -e;
+		if (e < 10)
+			*p++ = '0';
+		p += lept_utoa((uint64_t)e, p);
+	}
+	else if (kk >= n) {
+		// 1234e2 -> 123400
+		memcpy(p, digits, n);
+		p += n;
+		for (i = n; i < kk; i++)
+			*p++ = '0';
+	}
+	else if (kk > 0) {
+		// 1234e-2 -> 12.34
+		memcpy(p, digits, kk);
+		p += kk;
+		*p++ = '.';
+		memcpy(p, digits + kk, n - kk);
+		p += n - kk;
+	}
+	else {
+		// 1234e-6 -> 0.001234
+		*p++ = '0';
+		*p++ = '.';
+		for (i = kk; i < 0; i++)
+			*p++ = '0';
+		memcpy(p, digits, n);
+		p += n;
+	}
+	return (int)(p - buffer);
+}
+
+// صʱ򣬻ܹ˾ͰchunkһһνȥʣµĲһεƵͷ
+static int lept_stringify_flush(lept_context* c) {
 	size_t i;
-	assert(s != NULL);
-	PUTC(c, '"');
-	for (i = 0; i < len; i++) {
-		unsigned char ch = (unsigned char)s[i];
+	if (!c->write || c->top < c->chunk)
+		return LEPT_STRINGIFY_OK;
+	for (i = 0; i + c->chunk <= c->top; i += c->chunk)
+		if (!c->write(c->user, c->stack + i, c->chunk))
+			return LEPT_STRINGIFY_ABORTED;
+	LEPT_STAT_ADD(output_bytes, i);
+	memmove(c->stack, c->stack + i, c->top - i);
+	c->top -= i;
+	return LEPT_STRINGIFY_OK;
+}
+
+// һÿֽڶ"\u00XX"ȰһԤã
+// lept_scan_stringҪתֽڣм䲻תһֱmemcpy
+static char* lept_stringify_segment(char* p, const char* s, const char* end) {
+	static const char hex_digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+	while (s != end) {
+		const char* q = lept_scan_string(s, end);
+		unsigned char ch;
+		memcpy(p, s, q - s);
+		p += q - s;
+		if (q == end)
+			break;
+		ch = (unsigned char)*q;
+		s = q + 1;
+		*p++ = '\\';
 		switch (ch) {
-		case '\"': PUTS(c, "\\\"", 2); break;
-		case '\\': PUTS(c, "\\\\", 2); break;
-		case '\b': PUTS(c, "\\b", 2); break;
-		case '\f': PUTS(c, "\\f", 2); break;
-		case '\n': PUTS(c, "\\n", 2); break;
-		case '\r': PUTS(c, "\\r", 2); break;
-		case '\t': PUTS(c, "\\t", 2); break;
-		default:
-			if (ch < 0x20) { // TODO:\δUnicode
-				char buffer[7];
-				sprintf(buffer, "\\u%04X", ch);
-				PUTS(c, buffer, 6);
-			}
-			else
-				PUTC(c, s[i]);
+			case '\"': *p++ = '\"'; break;
+			case '\\': *p++ = '\\'; break;
+			case '\b': *p++ = 'b';  break;
+			case '\f': *p++ = 'f';  break;
+			case '\n': *p++ = 'n';  break;
+			case '\r': *p++ = 'r';  break;
+			case '\t': *p++ = 't';  break;
+			default:
+				*p++ = 'u'; *p++ = '0'; *p++ = '0';
+				*p++ = hex_digits[ch >> 4];
+				*p++ = hex_digits[ch & 15];
 		}
 	}
+	return p;
+}
+
+static int lept_stringify_string(lept_context* c, const char* s, size_t len) {
+	const char* end = s + len;
+	int ret;
+	assert(s != NULL);
+	PUTC(c, '"');
+	while (s != end) {
+		// ַܳҲֶת壬ÿòԤռϵֻһε6
+		size_t n = (size_t)(end - s) > LEPT_STRINGIFY_SEGMENT_SIZE ? LEPT_STRINGIFY_SEGMENT_SIZE : (size_t)(end - s);
+		char* head = (char*)lept_context_push(c, n * 6);
+		c->top -= n * 6 - (lept_stringify_segment(head, s, s + n) - head);
+		s += n;
+		if (c->write && (ret = lept_stringify_flush(c)) != LEPT_STRINGIFY_OK)
+			return ret;
+	}
 	PUTC(c, '"');
+	return LEPT_STRINGIFY_OK;
 }
 
+// lept_freeһʽջݹ
 static int lept_stringify_value(lept_context* c, const lept_value* v) {
-	size_t i;
-	int ret;
-	switch (v->type) {
-		case LEPT_NULL:   PUTS(c, "null", 4); break;
-		case LEPT_FALSE:  PUTS(c, "false", 5); break;
-		case LEPT_TRUE:   PUTS(c, "true", 4); break;
-		/*case LEPT_NUMBER: {
-			char* buffer = lept_context_push(c, 32);
-			int length = sprintf(buffer, "%.17g", v->u.n);
-			c->top -= 32 - length;
-		}*/
-		case LEPT_NUMBER:
-			c->top -= 32 - sprintf(lept_context_push(c, 32), "%.17g", v->u.n);
+	lept_walk w;
+	int ret = LEPT_STRINGIFY_OK;
+	LEPT_STAT_START(LEPT_PHASE_STRINGIFY);
+	lept_walk_init(&w, c->alloc);
+	for (;;) {
+		if ((ret = lept_stringify_flush(c)) != LEPT_STRINGIFY_OK)
 			break;
-		case LEPT_STRING: lept_stringify_string(c, v->u.s.s, v->u.s.len); break;
-		case LEPT_ARRAY:
-			PUTC(c, '[');
-			for (i = 0; i < v->u.a.size; i++) {
-				if (i > 0)
+		LEPT_EXPAND(v);
+		switch (v->type) {
+			case LEPT_NULL:   PUTS(c, "null", 4); break;
+			case LEPT_FALSE:  PUTS(c, "false", 5); break;
+			case LEPT_TRUE:   PUTS(c, "true", 4); break;
+			case LEPT_NUMBER:
+				c->top -= 32 - lept_dtoa(v->u.n, (char*)lept_context_push(c, 32));
+				break;
+			case LEPT_STRING: ret = lept_stringify_string(c, LEPT_STR(v), LEPT_STR_LEN(v)); break;
+			case LEPT_ARRAY:  PUTC(c, '['); lept_walk_push(&w, v); break;
+			case LEPT_OBJECT: PUTC(c, '{'); lept_walk_push(&w, v); break;
+		}
+		if (ret != LEPT_STRINGIFY_OK)
+			break;
+		// һҪֵԪض/Ͻ
+		for (v = NULL; v == NULL && w.top; ) {
+			lept_walk_entry* t = &w.e[w.top - 1];
+			const lept_value* x = t->v;
+			if (x->type == LEPT_ARRAY) {
+				if (t->i == x->u.a.size) {
+					PUTC(c, ']');
+					w.top--;
+					continue;
+				}
+				if (t->i > 0)
 					PUTC(c, ',');
-				lept_stringify_value(c, &v->u.a.e[i]);
+				v = &x->u.a.e[t->i++];
 			}
-			PUTC(c, ']');
-			break;
-		case LEPT_OBJECT:
-			PUTC(c, '{');
-			for (i = 0; i < v->u.o.size; i++) {
-				if (i > 0)
+			else {
+				if (t->i == x->u.o.size) {
+					PUTC(c, '}');
+					w.top--;
+					continue;
+				}
+				if (t->i > 0)
 					PUTC(c, ',');
-				lept_stringify_string(c, v->u.o.m[i].k, v->u.o.m[i].klen);
+				if ((ret = lept_stringify_string(c, LEPT_KEY(&x->u.o.m[t->i]), x->u.o.m[t->i].klen)) != LEPT_STRINGIFY_OK)
+					break;
 				PUTC(c, ':');
-				lept_stringify_value(c, &v->u.o.m[i].v);
-			}
-			PUTC(c, '}');
-			break;
-		
-	}
-	return LEPT_STRINGIFY_OK;
-}
-/*
- ʹÿռ任ȡʱŻԤȷڴ档
-static void lept_stringify_string(lept_context* c, const char* s, size_t len) {
-	static const char hex_digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
-	size_t i, size;
-	char* head, *p;
-	assert(s != NULL);
-	p = head = lept_context_push(c, size = len * 6 + 2); // "\u00xx..."
-	*p++ = '"';
-	for (i = 0; i < len; i++) {
-		unsigned char ch = (unsigned char)s[i];
-		switch (ch) {
-			case '\"': *p++ = '\\'; *p++ = '\"'; break;
-			case '\\': *p++ = '\\'; *p++ = '\\'; break;
-			case '\b': *p++ = '\\'; *p++ = 'b';  break;
-			case '\f': *p++ = '\\'; *p++ = 'f';  break;
-			case '\n': *p++ = '\\'; *p++ = 'n';  break;
-			case '\r': *p++ = '\\'; *p++ = 'r';  break;
-			case '\t': *p++ = '\\'; *p++ = 't';  break;
-			default:
-			if (ch < 0x20) {
-				*p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
-				*p++ = hex_digits[ch >> 4];
-				*p++ = hex_digits[ch & 15];
+				v = &x->u.o.m[t->i++].v;
 			}
-			else
-				*p++ = s[i];
 		}
+		if (ret != LEPT_STRINGIFY_OK || v == NULL)
+			break;
 	}
-	*p++ = '"';
-	c->top -= size - (p - head);
+	lept_walk_free(&w);
+	LEPT_STAT_STOP(LEPT_PHASE_STRINGIFY);
+	return ret;
 }
-*/
 
-int lept_stringify(const lept_value* v, char** json, size_t* length) {
+int lept_stringify_with(const lept_value* v, char** json, size_t* length, const lept_allocator* a) {
 	lept_context c;
 	int ret;
 	assert(v != NULL);
 	assert(json != NULL);
-	c.stack = (char*)malloc(c.size = LEPT_PARSE_STRINGIFY_INIT_SIZE);
-	c.top = 0;
+	lept_context_init(&c, NULL, 0);
+	if (a)
+		c.alloc = a;
+	c.stack = (char*)LEPT_MALLOC(c.alloc, c.size = LEPT_PARSE_STRINGIFY_INIT_SIZE);
+	LEPT_STAT_ADD(mallocs, 1);
+	LEPT_STAT_ADD(malloc_bytes, c.size);
 	if ((ret = lept_stringify_value(&c, v)) != LEPT_STRINGIFY_OK) {
-		free(c.stack);
+		LEPT_FREE(c.alloc, c.stack);
 		*json = NULL;
 		return ret;
 	}
+	LEPT_STAT_ADD(output_bytes, c.top);
 	if (length)
 		*length = c.top;
 	PUTC(&c, '\0');
@@ -641,4 +4517,81 @@ int lept_stringify(const lept_value* v, char** json, size_t* length) {
 	return LEPT_STRINGIFY_OK;
 }
 
+int lept_stringify(const lept_value* v, char** json, size_t* length) {
+	return lept_stringify_with(v, json, length, NULL);
+}
+
+int lept_stringify_sink(const lept_value* v, size_t chunk, lept_write_func write, void* user) {
+	lept_context c;
+	int ret;
+	assert(v != NULL && write != NULL);
+	lept_context_init(&c, NULL, 0);
+	c.write = write;
+	c.user = user;
+	c.chunk = chunk ? chunk : LEPT_STRINGIFY_FLUSH_SIZE;
+	// ÿflush֮һֻһСַһ㲻Ҫ
+	c.stack = (char*)LEPT_MALLOC(c.alloc, c.size = c.chunk + LEPT_PARSE_STRINGIFY_INIT_SIZE);
+	LEPT_STAT_ADD(mallocs, 1);
+	LEPT_STAT_ADD(malloc_bytes, c.size);
+	if ((ret = lept_stringify_value(&c, v)) == LEPT_STRINGIFY_OK && (ret = lept_stringify_flush(&c)) == LEPT_STRINGIFY_OK) {
+		if (c.top && !write(user, c.stack, c.top)) // һεĲ
+			ret = LEPT_STRINGIFY_ABORTED;
+		else
+			LEPT_STAT_ADD(output_bytes, c.top);
+	}
+	LEPT_FREE(c.alloc, c.stack);
+	return ret;
+}
+
+void lept_writer_init(lept_writer* w) {
+	assert(w != NULL);
+	w->stack = NULL;
+	w->size = w->peak = 0;
+	w->uses = 0;
+}
+
+int lept_writer_stringify(lept_writer* w, const lept_value* v, const char** json, size_t* length) {
+	lept_context c;
+	int ret;
+	assert(w != NULL && v != NULL && json != NULL);
+	// һεĽʱѾûˣ
+	lept_scratch_shrink(&w->stack, &w->size, &w->peak, &w->uses);
+	lept_context_init(&c, NULL, 0);
+	c.stack = w->stack;
+	c.size = w->size;
+	c.peak = w->peak;
+	if ((ret = lept_stringify_value(&c, v)) == LEPT_STRINGIFY_OK) {
+		LEPT_STAT_ADD(output_bytes, c.top);
+		if (length)
+			*length = c.top;
+		PUTC(&c, '\0');
+		*json = c.stack;
+	}
+	else
+		*json = NULL;
+	w->stack = c.stack;
+	w->size = c.size;
+	w->peak = c.peak;
+	return ret;
+}
+
+void lept_writer_free(lept_writer* w) {
+	assert(w != NULL);
+	LEPT_FREE(LEPT_GLOBAL, w->stack);
+	lept_writer_init(w);
+}
+
+static int lept_write_file(void* user, const char* s, size_t len) {
+	return fwrite(s, 1, len, (FILE*)user) == len;
+}
+
+int lept_stringify_file(const lept_value* v, FILE* fp) {
+	int ret;
+	assert(v != NULL && fp != NULL);
+	ret = lept_stringify_sink(v, LEPT_STRINGIFY_FLUSH_SIZE, lept_write_file, fp);
+	if (ret == LEPT_STRINGIFY_ABORTED || (ret == LEPT_STRINGIFY_OK && fflush(fp) != 0))
+		ret = LEPT_FILE_ERROR;
+	return ret;
+}
+
 
@@ -2,10 +2,12 @@
 #include <stdlib.h>  /* NULL */
 #include <errno.h>
 #include <math.h>    /* HUGE_VAL */
+#include <stdio.h>   /* FILE */
+#include <stdint.h>  /* uint64_t */
 #ifndef LEPTJSON_H__
 #define LEPTJSON_H__
 
-#define lept_init(v) do { (v)->type = LEPT_NULL; } while(0)
+#define lept_init(v) do { (v)->type = LEPT_NULL; (v)->flags = 0; } while(0)
 #define lept_set_null(v) lept_free(v)
 
 typedef enum { LEPT_NULL, LEPT_FALSE, LEPT_TRUE, LEPT_NUMBER, LEPT_STRING, LEPT_ARRAY, LEPT_OBJECT } lept_type;
@@ -13,20 +15,40 @@ typedef enum { LEPT_NULL, LEPT_FALSE, LEPT_TRUE, LEPT_NUMBER, LEPT_STRING, LEPT_
 typedef struct lept_value lept_value;
 typedef struct lept_member lept_member;
 
+// ôֱַӴlept_valueLEPT_SHORT_KEY_MAXļֱӴlept_member
+#define LEPT_SHORT_STRING_MAX 15
+#define LEPT_SHORT_KEY_MAX 7
+
 struct lept_value {
 	union {
 		struct { lept_member* m; size_t size; } o;    //  
 		struct { lept_value* e; size_t size; } a;     //  
 		struct { char* s; size_t len; } s;            // ַ
+		char ss[LEPT_SHORT_STRING_MAX + 1];           // ַLEPT_FLAG_SHORT
 		double n;                                     // 
 	} u;
 	lept_type type;
+	unsigned char flags;                              // LEPT_FLAG_*
 }; // ǰ֮Ͳȥ
 
+// ֵַָڴ桢߶мֵ(ԭؽʱָ뻺)lept_freeͷ
+#define LEPT_FLAG_BORROWED 0x1
+// ĳԱмĹϣlept_find_object_index
+#define LEPT_FLAG_INDEXED 0x2
+// ַ//ûչu.sеԭģһηʵʱչlept_parse_lazy
+#define LEPT_FLAG_LAZY 0x4
+// ַu.ssu.ss[LEPT_SHORT_STRING_MAX]LEPT_SHORT_STRING_MAXȥȣֵʱҲǽβ'\0'
+// ַҪlept_get_stringȡֵƶ(縴lept_value)֮ǰȡָʧЧ
+#define LEPT_FLAG_SHORT 0x8
+// ĳפеģlept_freeʱüͷţlept_intern
+#define LEPT_FLAG_INTERNED 0x10
+// /޸ĹģԪǰͷŵʱҪһͷţlept_reserve_array
+#define LEPT_FLAG_CAPACITY 0x20
+
 struct lept_member {
-	char* k; size_t klen;   /* member key string, key string length */
+	union { char* p; char s[LEPT_SHORT_KEY_MAX + 1]; } k; size_t klen;   /* member key string, key string length */
 	lept_value v;           /* member value */
-};
+}; // klenLEPT_SHORT_KEY_MAXʱk.sk.plept_get_object_keyȡ
 
 
 enum {
@@ -44,16 +66,173 @@ enum {
 	LEPT_PARSE_MISS_KEY = 11, // ȱټֵ
 	LEPT_PARSE_MISS_COLON = 12, // ȱð
 	LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET = 13, // ȱٷֺŻߴ
-	LEPT_STRINGIFY_OK = 14 // ַ
+	LEPT_STRINGIFY_OK = 14, // ַ
+	LEPT_PARSE_ABORTED = 15, // SAXصҪֹͣ
+	LEPT_FILE_ERROR = 16, // ļ򲻿ӳʧܻдʧ
+	LEPT_STRINGIFY_ABORTED = 17, // ص0
+	LEPT_PARSE_DEPTH_EXCEEDED = 18, // ͶǶ׵̫LEPT_PARSE_MAX_DEPTH
+	LEPT_PARSE_TYPE_MISMATCH = 19 // ֵͺlept_fieldĲһ
 };
 
 
+// arenaڴ涼Ӽгͷŵʱͷ
+typedef struct lept_arena_block lept_arena_block;
+typedef struct {
+	lept_arena_block* head;   // ǰʹõĿ飬֮
+	size_t block_size;        // һ¿ĴСÿη
+	size_t blocks;            // ǰеĿҲmallocĴ
+} lept_arena;
+
+#ifndef LEPT_ARENA_BLOCK_SIZE
+#define LEPT_ARENA_BLOCK_SIZE 4096
+#endif
+
+void lept_arena_init(lept_arena* a);
+void* lept_arena_alloc(lept_arena* a, size_t size);
+void lept_arena_reset(lept_arena* a); // ֻһ飬ͷţ֮ǰȫʧЧ
+void lept_arena_free(lept_arena* a);
+
+// פͬһĵУͬĳ(LEPT_SHORT_KEY_MAX)ֻһݣͬһָ
+// ÿݼülept_freeʱһֻͬһ߳ʹ
+typedef struct {
+	char** keys;              // ѰַĹϣǼݣNULLǿղ
+	size_t size, capacity;    // ĸͲ۵ĸ
+} lept_intern;
+
+void lept_intern_init(lept_intern* t);
+void lept_intern_free(lept_intern* t); // ֻŵԼãԽ
+
 void lept_free(lept_value* v);
 lept_type lept_get_type(const lept_value* v);
 
 
+// ͶǶ׵Ĳ˷LEPT_PARSE_DEPTH_EXCEEDED
+#ifndef LEPT_PARSE_MAX_DEPTH
+#define LEPT_PARSE_MAX_DEPTH 1024
+#endif
+
+// lept_parserlept_writerõĻÿôμһҪҪ
+#ifndef LEPT_SCRATCH_WINDOW
+#define LEPT_SCRATCH_WINDOW 64
+#endif
+
 // jsonַõһleptһڵ㣬ŵvУؽĽ
 int lept_parse(lept_value* v, const char* json);
+// ֻ[json, json + len)Ҫ'\0'βֱӽ󻺳еһΣм'\0'ǷǷַ
+int lept_parse_n(lept_value* v, const char* json, size_t len);
+// ļӳ䵽ڴֱӽļ򲻿ʱ򷵻LEPT_FILE_ERROR
+int lept_parse_file(lept_value* v, const char* path);
+// lept_parseһеַ顢󶼷arenaУܶԽlept_freelept_arena_reset/lept_arena_freeͷ
+int lept_parse_arena(lept_value* v, const char* json, lept_arena* a);
+// ԭؽַͼֱ֮дjsonָjsonjsonҪȽþãʱjsonݲȷ
+int lept_parse_insitu(lept_value* v, char* json);
+// lept_parse_nһǳtȡظ˳ǧεļֻһ
+int lept_parse_intern(lept_value* v, const char* json, size_t len, lept_intern* t);
+// ׶νSIMDҳнṹַλãЩλý
+// ʹ붼lept_parse_nһʱlept_parse_n½һõ
+int lept_parse_structural(lept_value* v, const char* json, size_t len);
+// ֻ﷨ַ顢󶼲չʵʱչһ㣬ûʵĲֲڴ
+// lept_parse_nһjsonҪȽþáչ޸ͬһڶ߳ͬʱ
+int lept_parse_lazy(lept_value* v, const char* json, size_t len);
+// vлûչֵչ֮ͺlept_parseĽһ
+void lept_expand(lept_value* v);
+
+// ṹֶһṹӦһnameΪNULLβ飬typeֶʲô
+// LEPT_TRUE/LEPT_FALSE: int01LEPT_NUMBER: doubleLEPT_STRING: char*mallocģ'\0'β
+// LEPT_OBJECT: Ƕ׵Ľṹ壬fieldsLEPT_ARRAY: lept_value飻LEPT_NULL: lept_valueʲôֵ
+typedef struct lept_field lept_field;
+struct lept_field {
+	const char* name;           // 
+	size_t offset;              // ֶڽṹеλãoffsetof
+	lept_type type;
+	const lept_field* fields;   // typeLEPT_OBJECTʱǶ׽ṹ
+};
+
+// jsonһ󣬰fieldsֱдṹsУsҪ
+// ûеļֻ﷨ڴ棻ûֵֶκֵΪnullֶβظļĸǰ
+// ͲԵʱ򷵻LEPT_PARSE_TYPE_MISMATCHʱѾдȥĶͷŵ
+int lept_parse_into(void* s, const lept_field* fields, const char* json, size_t len);
+// ͷlept_parse_intoַlept_valueָNULL
+void lept_free_into(void* s, const lept_field* fields);
+
+// SAX¼صΪNULL0ʾֹͣlept_parse_saxLEPT_PARSE_ABORTED
+// ַͼֻڻصڼЧ'\0'β֮ǰѾ¼᳷
+typedef struct {
+	int(*null)(void* user);
+	int(*boolean)(void* user, int b);
+	int(*number)(void* user, double n);
+	int(*string)(void* user, const char* s, size_t len);
+	int(*start_array)(void* user);
+	int(*end_array)(void* user, size_t count);
+	int(*start_object)(void* user);
+	int(*key)(void* user, const char* k, size_t klen);
+	int(*end_object)(void* user, size_t count);
+} lept_sax_handler;
+
+// ˳򷢳¼ֵlept_parseһ
+int lept_parse_sax(const char* json, const lept_sax_handler* handler, void* user);
+
+// ԷֳĿ飬λöϿʹlept_parseһ
+// max_depthinternֶǽм״̬Ҫֱӷ
+typedef struct {
+	char* stack;
+	size_t size, top;      // ʱջlept_parseõһ
+	size_t frame;          // ǰڵ/ջеλ
+	size_t peak;           // һʱʱջõ󳤶ȣ
+	unsigned uses;
+	size_t head;           // ڽַ/ջпʼλ
+	size_t depth;
+	size_t max_depth;      // Ƕ׵Ĳlept_parser_initΪLEPT_PARSE_MAX_DEPTH֮޸
+	lept_intern* intern;   // ΪNULLʱ򳤼ȡlept_parser_initΪNULL֮޸
+	lept_value root;
+	int state, sub, ret;
+	unsigned u, u2;        // \uת
+	const char* literal;   // ƥnull/true/falseʣµĲ
+} lept_parser;
+
+void lept_parser_init(lept_parser* p);
+// ιһ룬LEPT_PARSE_OKʾĿǰΪֹûд󣬷򷵻ش룬֮붼
+int lept_parser_feed(lept_parser* p, const char* buf, size_t len);
+// õսŵvУ֮pԽŽһĵ
+int lept_parser_finish(lept_parser* p, lept_value* v);
+void lept_parser_free(lept_parser* p);
+// һνһĵlept_parse_nһʱջpģŸһ
+// ܶСĵʱͲÿζʱջˣfeedһʱ
+int lept_parser_parse(lept_parser* p, lept_value* v, const char* json, size_t len);
+
+// NDJSONÿһjsonĵ
+// ÿһ¼һΣoffset¼ڻпʼλãretǽʱvnull
+// ص0ֹͣص֮vᱻͷţ԰*vlept_init(v)
+// orderedΪ0ʱһ߳ﰴ¼˳ãΪ0ʱڸֱ߳ӵãͬʱãҪԼ
+typedef int (*lept_record_func)(void* user, size_t offset, int ret, lept_value* v);
+// зthreads߳̽õ߳Ҳһ0ʱCPU
+// ÿ¼Ĵͨص棻صҪֹͣLEPT_PARSE_ABORTED򷵻LEPT_PARSE_OK
+int lept_parse_ndjson(const char* json, size_t len, int threads, int ordered, lept_record_func record, void* user);
+// ӳļlept_parse_ndjson򲻿LEPT_FILE_ERROR
+int lept_parse_ndjson_file(const char* path, int threads, int ordered, lept_record_func record, void* user);
+
+// vΪjsonַ*jsonҪfreeͷţlengthΪNULL
+int lept_stringify(const lept_value* v, char** json, size_t* length);
+// ɵʱͬһֶβҪֱӷ
+typedef struct {
+	char* stack;
+	size_t size;
+	size_t peak;       // һʱõ󳤶ȣ
+	unsigned uses;
+} lept_writer;
+
+void lept_writer_init(lept_writer* w);
+// lept_stringifyһǽwĻУҪfreeһεûlept_writer_free֮ǰЧ
+int lept_writer_stringify(lept_writer* w, const lept_value* v, const char** json, size_t* length);
+void lept_writer_free(lept_writer* w);
+
+// صsʼlenֽǽһ0ʾ
+typedef int (*lept_write_func)(void* user, const char* s, size_t len);
+// ɱ߽writeһΣÿchunkֽ(Ϊ0ʱLEPT_STRINGIFY_FLUSH_SIZE)
+// õĻֻchunkСңwrite0ʱͣLEPT_STRINGIFY_ABORTED
+int lept_stringify_sink(const lept_value* v, size_t chunk, lept_write_func write, void* user);
+// ɱдfpУڴַܳдʧܷLEPT_FILE_ERROR
+int lept_stringify_file(const lept_value* v, FILE* fp);
 
 int lept_get_boolean(const lept_value* v);
 void lept_set_boolean(lept_value* v, int b);
@@ -73,4 +252,113 @@ const char* lept_get_object_key(const lept_value* v, size_t index);
 size_t lept_get_object_key_length(const lept_value* v, size_t index);
 lept_value* lept_get_object_value(const lept_value* v, size_t index);
 
+#define LEPT_KEY_NOT_EXIST ((size_t)-1)
+// ҳԱҲLEPT_KEY_NOT_EXIST/NULLظļʱصһ
+// ԱȽ϶ĶʱὨϣO(1)ģԲ
+size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen);
+lept_value* lept_find_object_value(const lept_value* v, const char* key, size_t klen);
+
+// ޸Ͷ׷ԪغͰóԱǾ̯O(1)ģ޸֮ǰȡԪ/ԱָʧЧ
+// ޸õȫֵķԲ޸arenalept_parse_withֵ
+void lept_set_array(lept_value* v, size_t capacity);    // ΪcapacityĿ
+size_t lept_get_array_capacity(const lept_value* v);
+void lept_reserve_array(lept_value* v, size_t capacity);
+void lept_shrink_array(lept_value* v);                  // Ԫظ
+void lept_clear_array(lept_value* v);                   // ɾԪأ
+lept_value* lept_pushback_array_element(lept_value* v); // һnull
+void lept_popback_array_element(lept_value* v);
+lept_value* lept_insert_array_element(lept_value* v, size_t index); // index֮ǰһnull
+void lept_erase_array_element(lept_value* v, size_t index, size_t count);
+
+void lept_set_object(lept_value* v, size_t capacity);
+size_t lept_get_object_capacity(const lept_value* v);
+void lept_reserve_object(lept_value* v, size_t capacity);
+void lept_shrink_object(lept_value* v);
+void lept_clear_object(lept_value* v);
+// ͷֵûоһֵΪnullĳԱֵ
+lept_value* lept_set_object_value(lept_value* v, const char* key, size_t klen);
+void lept_remove_object_value(lept_value* v, size_t index);
+
+// tapeĵųһ64λֵ飬ַһʱֻ˳ڴ
+// һֵwordsе±ʾ0ֶβҪֱ޸
+typedef struct {
+	uint64_t* words;
+	size_t size, capacity;
+	char* strings;
+	size_t string_size, string_capacity;
+} lept_tape;
+
+void lept_tape_init(lept_tape* t);
+void lept_tape_free(lept_tape* t);
+// ֱӽtapelept_parse_nһtԭݱǣ
+int lept_parse_tape(lept_tape* t, const char* json, size_t len);
+// vתtapetԭ
+void lept_tape_from_value(lept_tape* t, const lept_value* v);
+// ±iֵתŵvУvԭݲͷ
+void lept_tape_to_value(const lept_tape* t, size_t i, lept_value* v);
+
+lept_type lept_tape_get_type(const lept_tape* t, size_t i);
+// iһֵͶO(1)ģĵһԪi+2
+size_t lept_tape_next(const lept_tape* t, size_t i);
+int lept_tape_get_boolean(const lept_tape* t, size_t i);
+double lept_tape_get_number(const lept_tape* t, size_t i);
+const char* lept_tape_get_string(const lept_tape* t, size_t i);
+size_t lept_tape_get_string_length(const lept_tape* t, size_t i);
+// ±Ԫ/ԱҪͷǰģO(index)ģ˳lept_tape_next
+size_t lept_tape_get_array_size(const lept_tape* t, size_t i);
+size_t lept_tape_get_array_element(const lept_tape* t, size_t i, size_t index);
+size_t lept_tape_get_object_size(const lept_tape* t, size_t i);
+const char* lept_tape_get_object_key(const lept_tape* t, size_t i, size_t index);
+size_t lept_tape_get_object_key_length(const lept_tape* t, size_t i, size_t index);
+size_t lept_tape_get_object_value(const lept_tape* t, size_t i, size_t index);
+// Բңֵ±꣬ҲLEPT_KEY_NOT_EXIST
+size_t lept_tape_find_object_value(const lept_tape* t, size_t i, const char* key, size_t klen);
+
+// еڴ䶼ͨuserԭȥ
+// resizereleaseյNULLresizeʧܺallocһNULL(ѷʧܵᷢ)
+typedef struct {
+	void* (*alloc)(void* user, size_t size);
+	void* (*resize)(void* user, void* p, size_t size);
+	void (*release)(void* user, void* p);
+	void* user;
+} lept_allocator;
+
+// ȫֵķaΪNULLʱָmalloc/realloc/free
+// Ҫڷκζ֮ǰãȫַĶڻ֮ǰҪͷŵ
+void lept_set_allocator(const lept_allocator* a);
+// ʱջa䣬aΪNULLʱȫֵģҪlept_free_with(v, a)ͷ
+// Ľlept_parserlept_arenalept_internlept_tapeȵȫֵķ
+int lept_parse_with(lept_value* v, const char* json, size_t len, const lept_allocator* a);
+void lept_free_with(lept_value* v, const lept_allocator* a);
+// ʱջa䣬*jsonҪa->releaseͷ
+int lept_stringify_with(const lept_value* v, char** json, size_t* length, const lept_allocator* a);
+
+// ʱLEPT_STATS(õlept_statsĴ붼Ҫ)ɵʱͳۼӵǰ̵߳lept_stats
+// ûжʱͳƵĴ붼ȥûκο
+#ifdef LEPT_STATS
+typedef enum {
+	LEPT_PHASE_PARSE,     // lept_parseϵкlept_parser
+	LEPT_PHASE_STRING,    // нַͼ
+	LEPT_PHASE_NUMBER,    // ת
+	LEPT_PHASE_STRINGIFY, // lept_stringifyϵе
+	LEPT_PHASE_COUNT
+} lept_phase;
+
+// bytesvaluesmax_depthֻͳƽlept_parseϵкlept_parserʱջͳеĽɶ
+typedef struct {
+	size_t bytes;                   // ֽ
+	size_t output_bytes;            // ɵֽ
+	size_t values[LEPT_OBJECT + 1]; // ĸ͵ֵĸ±lept_type
+	size_t mallocs, malloc_bytes;   // פarena顢ɵĻmallocĴֽ
+	size_t reallocs, realloc_bytes; // ʱջreallocĴÿrealloc֮ĴС֮
+	size_t stack_peak;              // ʱջߵֽ
+	size_t max_depth;               // ͶǶ˼
+	uint64_t cycles[LEPT_PHASE_COUNT]; // ͬʱLEPT_STATS_CYCLESͳƣx86rdtscļƽ̨clock()
+} lept_stats;
+
+// /ȡǰ̵߳ͳƣlept_parse_ndjsonĹ̵߳ͳƣڷ֮ǰӵõ߳
+void lept_stats_reset();
+void lept_stats_get(lept_stats* s);
+#endif
+
 #endif /* LEPTJSON_H__ */
@@ -1,9 +1,12 @@
 
+#if defined(_MSC_VER)
 #define _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>  /* offsetof */
 #include <string.h>
 #include "leptjson.h"
 #include <errno.h>
@@ -29,12 +32,75 @@ static int test_pass = 0;
 #define EXPECT_EQ_STRING(expect, actual, alength) \
     EXPECT_EQ_BASE(sizeof(expect) - 1 == alength && memcmp(expect, actual, alength) == 0, expect, actual, "%s")
 
+// ɵjsonһ
+static void expect_same_value(const lept_value* a, const lept_value* b) {
+	char *s1, *s2;
+	size_t n1, n2;
+	lept_stringify(a, &s1, &n1);
+	lept_stringify(b, &s2, &n2);
+	EXPECT_EQ_INT(1, n1 == n2 && memcmp(s1, s2, n1) == 0);
+	free(s1);
+	free(s2);
+}
+
+// jsonƵһlenֽڡû'\0'βڴlept_parse_nԽܱ
+// ˳lept_parse_structuralĽһ
+static int parse_exact(lept_value* v, const char* json, size_t len) {
+	char* buf = (char*)malloc(len ? len : 1);
+	lept_value v2;
+	lept_tape t;
+	lept_intern in;
+	int ret;
+	memcpy(buf, json, len);
+	ret = lept_parse_n(v, buf, len);
+	EXPECT_EQ_INT(ret, lept_parse_structural(&v2, buf, len));
+	if (ret == LEPT_PARSE_OK)
+		expect_same_value(v, &v2);
+	else
+		EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v2));
+	lept_free(&v2);
+	// Ҳǣɵʱչеֵ
+	EXPECT_EQ_INT(ret, lept_parse_lazy(&v2, buf, len));
+	if (ret == LEPT_PARSE_OK)
+		expect_same_value(v, &v2);
+	else
+		EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v2));
+	lept_free(&v2);
+	// פҲһʱѾȡļȥ
+	lept_intern_init(&in);
+	EXPECT_EQ_INT(ret, lept_parse_intern(&v2, buf, len, &in));
+	if (ret == LEPT_PARSE_OK)
+		expect_same_value(v, &v2);
+	lept_free(&v2);
+	lept_intern_free(&in);
+	// tapeת֮ҲһתtapeתҲһ
+	lept_tape_init(&t);
+	EXPECT_EQ_INT(ret, lept_parse_tape(&t, buf, len));
+	if (ret == LEPT_PARSE_OK) {
+		lept_tape_to_value(&t, 0, &v2);
+		expect_same_value(v, &v2);
+		lept_free(&v2);
+		lept_tape_from_value(&t, v);
+		lept_tape_to_value(&t, 0, &v2);
+		expect_same_value(v, &v2);
+		lept_free(&v2);
+	}
+	else
+		EXPECT_EQ_INT(0, (int)t.size);
+	lept_tape_free(&t);
+	free(buf);
+	return ret;
+}
+
 #define TEST_ERROR(error, json)\
     do {\
         lept_value v;\
         v.type = LEPT_FALSE;\
         EXPECT_EQ_INT(error, lept_parse(&v, json));\
         EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));\
+        v.type = LEPT_FALSE;\
+        EXPECT_EQ_INT(error, parse_exact(&v, json, strlen(json)));\
+        EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));\
     } while(0)
 
 
@@ -44,6 +110,8 @@ static int test_pass = 0;
         EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));\
         EXPECT_EQ_INT(LEPT_NUMBER, lept_get_type(&v));\
         EXPECT_EQ_DOUBLE(expect, lept_get_number(&v));\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, parse_exact(&v, json, strlen(json)));\
+        EXPECT_EQ_DOUBLE(expect, lept_get_number(&v));\
     } while(0)
 
 
@@ -63,6 +131,8 @@ static int test_pass = 0;
         EXPECT_EQ_INT(LEPT_STRING, lept_get_type(&v));\
         EXPECT_EQ_STRING(expect, lept_get_string(&v), lept_get_string_length(&v));\
         lept_free(&v);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, parse_exact(&v, json, strlen(json)));\
+        lept_free(&v);\
     } while(0)
 
 #define EXPECT_TRUE(actual) EXPECT_EQ_BASE((actual) != 0, "true", "false", "%s")
@@ -113,6 +183,12 @@ static void test_parse_number_too_big() {
 
 	TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "1e309");
 	TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "-1e309");
+	/* double2^1024е㣬ż */
+	TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG,
+		"1797693134862315807937289714053034150799341327100378269361737789804449682927647509466490179775872070"
+		"9633028641669288791094655554785194040263065748867150582068190890200070838367627385484581771153176447"
+		"5730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904"
+		"174497792");
 }
 
 static void test_parse_number() {
@@ -152,6 +228,40 @@ static void test_parse_number() {
 	/* Max double */
 	TEST_NUMBER(1.7976931348623157e+308, "1.7976931348623157e+308");
 	TEST_NUMBER(-1.7976931348623157e+308, "-1.7976931348623157e+308");
+
+	/* 19λЧ֣ԼպdoubleмҪż */
+	TEST_NUMBER(12345678901234567890123.0, "12345678901234567890123");
+	TEST_NUMBER(9007199254740992.0, "9007199254740993");
+	TEST_NUMBER(1.0, "1.00000000000000011102230246251565404236316680908203125");
+	TEST_NUMBER(1.0000000000000002, "1.00000000000000011102230246251565404236316680908203125001");
+	TEST_NUMBER(0.1, "0.1");
+	TEST_NUMBER(0.1, "0.000000000000000000000000000000000000000001e41");
+	TEST_NUMBER(123456.789e-300, "123456.789e-300");
+	/* Сķǹһ5^1075 * 10^-1075պһż뵽0ٶһСķǹ */
+	TEST_NUMBER(0.0,
+		"2470328229206232720882843964341106861825299013071623822127928412503377536351043759326499181808179961"
+		"8989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435"
+		"9318028499365361525003193704576782492193656236698636584807570015857692699037063119282795585513329278"
+		"3433840935197801553124659726357957462276646527282722005637400648549997709659947045402082816622623785"
+		"7393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914"
+		"4672918403005300575308490487653917113865916462395249126236538818796362393732804238910186723484976682"
+		"3508986338858792562830275599565752445550725518931369083625477918694866799496832404970582102851318545"
+		"1396213837722826145437693412532098591327667236328125e-1075");
+	TEST_NUMBER(4.9406564584124654e-324,
+		"2470328229206232720882843964341106861825299013071623822127928412503377536351043759326499181808179961"
+		"8989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435"
+		"9318028499365361525003193704576782492193656236698636584807570015857692699037063119282795585513329278"
+		"3433840935197801553124659726357957462276646527282722005637400648549997709659947045402082816622623785"
+		"7393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914"
+		"4672918403005300575308490487653917113865916462395249126236538818796362393732804238910186723484976682"
+		"3508986338858792562830275599565752445550725518931369083625477918694866799496832404970582102851318545"
+		"13962138377228261454376934125320985913276672363281251e-1076");
+	/* double2^1024е1double */
+	TEST_NUMBER(1.7976931348623157e+308,
+		"1797693134862315807937289714053034150799341327100378269361737789804449682927647509466490179775872070"
+		"9633028641669288791094655554785194040263065748867150582068190890200070838367627385484581771153176447"
+		"5730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904"
+		"174497791");
 }
 
 
@@ -167,6 +277,11 @@ static void test_parse_string() {
 	TEST_STRING("\xE2\x82\xAC", "\"\\u20AC\""); /* Euro sign U+20AC */
 	TEST_STRING("\xF0\x9D\x84\x9E", "\"\\uD834\\uDD1E\"");  /* G clef sign U+1D11E */
 	TEST_STRING("\xF0\x9D\x84\x9E", "\"\\ud834\\udd1e\"");  /* G clef sign U+1D11E */
+	/* һȵַͨԼԽ߽ת */
+	TEST_STRING("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ", "\"0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\"");
+	TEST_STRING("0123456789abcdefghijklmnopqrstu\"vwxyz\\0123456789abcdef\n", "\"0123456789abcdefghijklmnopqrstu\\\"vwxyz\\\\0123456789abcdef\\n\"");
+	TEST_STRING("\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87",
+		"\"\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\"");
 }
 
 static void test_parse_missing_quotation_mark() {
@@ -187,6 +302,7 @@ static void test_parse_invalid_string_char() {
 
 	TEST_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, "\"\x01\"");
 	TEST_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, "\"\x1F\"");
+	TEST_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, "\"0123456789abcdefghijklmnopqrstuvwxyz\x1F\"");
 
 }
 
@@ -254,6 +370,36 @@ static void test_access_string() {
 	lept_free(&v);
 }
 
+// ַͶֱ̼ӴֵͳԱڱ߽ϵҲҪ
+static void test_short_string() {
+	const char* json = "{\"k\":\"\",\"7bytes_\":\"15 bytes long !\",\"8 bytes_\":\"16 bytes long !!\",\"z\":\"a\\u0000b\"}";
+	lept_value v, w;
+	lept_init(&v);
+	lept_set_string(&v, "15 bytes long !", 15);
+	EXPECT_TRUE(v.flags & LEPT_FLAG_SHORT);
+	EXPECT_EQ_STRING("15 bytes long !", lept_get_string(&v), lept_get_string_length(&v));
+	EXPECT_EQ_INT('\0', lept_get_string(&v)[15]);
+	// ֵַ֮Ҳ
+	w = v;
+	lept_init(&v);
+	EXPECT_EQ_STRING("15 bytes long !", lept_get_string(&w), lept_get_string_length(&w));
+	lept_set_string(&w, "16 bytes long !!", 16);
+	EXPECT_FALSE(w.flags & LEPT_FLAG_SHORT);
+	EXPECT_EQ_STRING("16 bytes long !!", lept_get_string(&w), lept_get_string_length(&w));
+	lept_free(&w);
+
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	EXPECT_EQ_STRING("", lept_get_string(lept_find_object_value(&v, "k", 1)), lept_get_string_length(lept_find_object_value(&v, "k", 1)));
+	EXPECT_EQ_STRING("7bytes_", lept_get_object_key(&v, 1), lept_get_object_key_length(&v, 1));
+	EXPECT_EQ_STRING("8 bytes_", lept_get_object_key(&v, 2), lept_get_object_key_length(&v, 2));
+	EXPECT_TRUE(lept_get_object_value(&v, 1)->flags & LEPT_FLAG_SHORT);
+	EXPECT_EQ_STRING("15 bytes long !", lept_get_string(lept_get_object_value(&v, 1)), lept_get_string_length(lept_get_object_value(&v, 1)));
+	EXPECT_FALSE(lept_get_object_value(&v, 2)->flags & LEPT_FLAG_SHORT);
+	EXPECT_EQ_STRING("16 bytes long !!", lept_get_string(lept_get_object_value(&v, 2)), lept_get_string_length(lept_get_object_value(&v, 2)));
+	EXPECT_EQ_STRING("a\0b", lept_get_string(lept_find_object_value(&v, "z", 1)), lept_get_string_length(lept_find_object_value(&v, "z", 1)));
+	lept_free(&v);
+}
+
 static void test_parse_array() {
 	lept_value v;
 	lept_init(&v);
@@ -261,6 +407,13 @@ static void test_parse_array() {
 	EXPECT_EQ_INT(LEPT_ARRAY, lept_get_type(&v));
 	EXPECT_EQ_SIZE_T(5, lept_get_array_size(&v));
 	lept_free(&v);
+
+	/* հ */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t1,\r\n                                                     2\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n]"));
+	EXPECT_EQ_INT(LEPT_ARRAY, lept_get_type(&v));
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+	lept_free(&v);
 }
 
 
@@ -314,7 +467,7 @@ static void test_parse_object() {
 		EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(o));
 		for (i = 0; i < 3; i++) {
 			lept_value* ov = lept_get_object_value(o, i);
-			EXPECT_TRUE('1' + i == lept_get_object_key(o, i)[0]);
+			EXPECT_TRUE((char)('1' + i) == lept_get_object_key(o, i)[0]);
 			EXPECT_EQ_SIZE_T(1, lept_get_object_key_length(o, i));
 			EXPECT_EQ_INT(LEPT_NUMBER, lept_get_type(ov));
 			EXPECT_EQ_DOUBLE(i + 1.0, lept_get_number(ov));
@@ -322,6 +475,931 @@ static void test_parse_object() {
 	}
 	lept_free(&v);
 }
+static void test_parse_arena() {
+	lept_arena a;
+	lept_value v;
+	size_t blocks;
+	lept_arena_init(&a);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, "{\"k\":[1,\"abc\",{\"x\":null}],\"s\":\"hello\"}", &a));
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(&v));
+	EXPECT_EQ_SIZE_T(2, lept_get_object_size(&v));
+	EXPECT_EQ_STRING("k", lept_get_object_key(&v, 0), lept_get_object_key_length(&v, 0));
+	EXPECT_EQ_SIZE_T(3, lept_get_array_size(lept_get_object_value(&v, 0)));
+	EXPECT_EQ_STRING("abc", lept_get_string(lept_get_array_element(lept_get_object_value(&v, 0), 1)),
+		lept_get_string_length(lept_get_array_element(lept_get_object_value(&v, 0), 1)));
+	EXPECT_EQ_STRING("hello", lept_get_string(lept_get_object_value(&v, 1)), lept_get_string_length(lept_get_object_value(&v, 1)));
+	blocks = a.blocks;
+	EXPECT_TRUE(blocks >= 1);
+
+	// reset֮鱻ãͬĵٿ¿
+	lept_arena_reset(&a);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, "{\"k\":[1,\"abc\",{\"x\":null}],\"s\":\"hello\"}", &a));
+	EXPECT_EQ_SIZE_T(1, a.blocks);
+
+	// ʱΪnullѾڴarena
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_arena(&v, "{\"a\":[\"x\",{\"b\":\"y\"}]", &a));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_arena(&v, "[\"x\",{\"b\":\"y\"}", &a));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	lept_arena_free(&a);
+	EXPECT_EQ_SIZE_T(0, a.blocks);
+}
+
+static void test_parse_insitu() {
+	char json[] = "{\"long key\\n\":[\"abc\",\"\\u20AC\\\"x\"],\"s\":\"hello\"}";
+	char bad[] = "[\"abc\", \"\\x\"]";
+	lept_value v;
+	lept_value* a;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&v, json));
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(&v));
+	EXPECT_EQ_SIZE_T(2, lept_get_object_size(&v));
+	EXPECT_EQ_STRING("long key\n", lept_get_object_key(&v, 0), lept_get_object_key_length(&v, 0));
+	EXPECT_TRUE(lept_get_object_key(&v, 0) >= json && lept_get_object_key(&v, 0) < json + sizeof(json));
+	a = lept_get_object_value(&v, 0);
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(a));
+	EXPECT_EQ_STRING("abc", lept_get_string(lept_get_array_element(a, 0)), lept_get_string_length(lept_get_array_element(a, 0)));
+	EXPECT_EQ_STRING("\xE2\x82\xAC\"x", lept_get_string(lept_get_array_element(a, 1)), lept_get_string_length(lept_get_array_element(a, 1)));
+	EXPECT_TRUE(lept_get_string(lept_get_array_element(a, 1)) >= json && lept_get_string(lept_get_array_element(a, 1)) < json + sizeof(json));
+	EXPECT_EQ_STRING("hello", lept_get_string(lept_get_object_value(&v, 1)), lept_get_string_length(lept_get_object_value(&v, 1)));
+	/* ָ벻ᱻͷ */
+	lept_free(&v);
+
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_ESCAPE, lept_parse_insitu(&v, bad));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+}
+
+static void test_parse_intern() {
+	const char* json = "[{\"customer_id\":1,\"id\":2},{\"customer_id\":3,\"id\":4}]";
+	lept_intern t;
+	lept_parser p;
+	lept_value v, w;
+	char buf[1024];
+	int i;
+	lept_intern_init(&t);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_intern(&v, json, strlen(json), &t));
+	// ֻһݣͬһָ룻̼ڳԱ
+	EXPECT_TRUE(lept_get_object_key(lept_get_array_element(&v, 0), 0) == lept_get_object_key(lept_get_array_element(&v, 1), 0));
+	EXPECT_EQ_SIZE_T(1, t.size);
+	EXPECT_TRUE(lept_get_array_element(&v, 0)->flags & LEPT_FLAG_INTERNED);
+
+	// ͬһĽĵҲ
+	lept_parser_init(&p);
+	p.intern = &t;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_feed(&p, json, 5));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_feed(&p, json + 5, strlen(json) - 5));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_finish(&p, &w));
+	EXPECT_TRUE(lept_get_object_key(lept_get_array_element(&v, 0), 0) == lept_get_object_key(lept_get_array_element(&w, 1), 0));
+	EXPECT_EQ_SIZE_T(1, t.size);
+	lept_parser_free(&p);
+
+	// ͷţãһͷŵʱͷ
+	lept_intern_free(&t);
+	lept_free(&v);
+	EXPECT_EQ_STRING("customer_id", lept_get_object_key(lept_get_array_element(&w, 0), 0), lept_get_object_key_length(lept_get_array_element(&w, 0), 0));
+	lept_free(&w);
+
+	// ԱĶñµĹϣֵ
+	strcpy(buf, "{");
+	for (i = 0; i < 40; i++)
+		sprintf(buf + strlen(buf), "%s\"key_number_%d\":%d", i ? "," : "", i, i);
+	strcat(buf, "}");
+	lept_intern_init(&t);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_intern(&v, buf, strlen(buf), &t));
+	EXPECT_TRUE(v.flags & LEPT_FLAG_INDEXED);
+	EXPECT_EQ_DOUBLE(23.0, lept_get_number(lept_find_object_value(&v, "key_number_23", 13)));
+	EXPECT_EQ_SIZE_T(40, t.size);
+	lept_free(&v);
+	lept_intern_free(&t);
+}
+
+// һ·õĴĶҪ
+typedef struct {
+	size_t allocs, resizes, releases;
+} test_allocator_count;
+
+static void* test_alloc(void* user, size_t size) {
+	((test_allocator_count*)user)->allocs++;
+	return malloc(size);
+}
+
+static void* test_resize(void* user, void* p, size_t size) {
+	((test_allocator_count*)user)->resizes++;
+	return realloc(p, size);
+}
+
+static void test_release(void* user, void* p) {
+	((test_allocator_count*)user)->releases++;
+	free(p);
+}
+
+static void test_parse_allocator() {
+	const char* json = "[1,\"a long string value\",{\"long key\":[true,null],\"k\":\"v\"}]";
+	test_allocator_count n, g;
+	lept_allocator a = { test_alloc, test_resize, test_release, NULL }, ga = a;
+	lept_value v, expect;
+	lept_intern t;
+	lept_tape tp;
+	char *s, *deep;
+	size_t length, i;
+	memset(&n, 0, sizeof(n));
+	a.user = &n;
+
+	// ʱջɵĻa䣬ͷ֮󶼻
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_with(&v, json, strlen(json), &a));
+	EXPECT_TRUE(n.allocs > 0 && n.resizes > 0);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&expect, json));
+	expect_same_value(&expect, &v);
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_with(&v, &s, &length, &a));
+	EXPECT_EQ_SIZE_T(strlen(json), length);
+	EXPECT_TRUE(memcmp(json, s, length) == 0);
+	a.release(a.user, s);
+	lept_free_with(&v, &a);
+	lept_free(&expect);
+	EXPECT_EQ_SIZE_T(n.allocs, n.releases);
+
+	// ʱѾĲҲa
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_with(&v, "[\"a long string value\",{\"long key\":[1,2]]", 41, &a));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parse_with(&v, "[\"a long string value\"] x", 25, &a));
+	EXPECT_EQ_SIZE_T(n.allocs, n.releases);
+
+	// Ƕ׵ͷźɵʱõջҲa
+	deep = (char*)malloc(2 * 200 + 1);
+	for (i = 0; i < 200; i++) {
+		deep[i] = '[';
+		deep[2 * 200 - 1 - i] = ']';
+	}
+	deep[2 * 200] = '\0';
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_with(&v, deep, 2 * 200, &a));
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_with(&v, &s, &length, &a));
+	EXPECT_TRUE(length == 2 * 200 && memcmp(deep, s, length) == 0);
+	a.release(a.user, s);
+	lept_free_with(&v, &a);
+	EXPECT_EQ_SIZE_T(n.allocs, n.releases);
+	free(deep);
+
+	// ȫֵķĽʽҲ
+	memset(&g, 0, sizeof(g));
+	ga.user = &g;
+	lept_set_allocator(&ga);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &s, &length));
+	ga.release(ga.user, s);
+	lept_free(&v);
+	lept_intern_init(&t);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_intern(&v, json, strlen(json), &t));
+	lept_free(&v);
+	lept_intern_free(&t);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, json, strlen(json)));
+	lept_expand(&v);
+	lept_free(&v);
+	lept_tape_init(&tp);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_tape(&tp, json, strlen(json)));
+	lept_tape_free(&tp);
+	lept_set_allocator(NULL);
+	EXPECT_TRUE(g.allocs > 0);
+	EXPECT_EQ_SIZE_T(g.allocs, g.releases);
+}
+
+static void test_find_object() {
+	lept_value v;
+	char json[1024], key[16];
+	size_t i;
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "{\"a\":1,\"b\":2,\"a\":3}"));
+	EXPECT_FALSE(v.flags & LEPT_FLAG_INDEXED);
+	EXPECT_EQ_SIZE_T(0, lept_find_object_index(&v, "a", 1));
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(lept_find_object_value(&v, "b", 1)));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "c", 1));
+	EXPECT_TRUE(lept_find_object_value(&v, "ab", 2) == NULL);
+	lept_free(&v);
+
+	/* ԱĶйϣٷһظļ */
+	strcpy(json, "{");
+	for (i = 0; i < 100; i++) {
+		sprintf(key, "\"k%d\":%d,", (int)i, (int)i);
+		strcat(json, key);
+	}
+	strcat(json, "\"k7\":-1,\"\":0}");
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	EXPECT_TRUE(v.flags & LEPT_FLAG_INDEXED);
+	for (i = 0; i < 100; i++) {
+		sprintf(key, "k%d", (int)i);
+		EXPECT_EQ_SIZE_T(i, lept_find_object_index(&v, key, strlen(key)));
+		EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_find_object_value(&v, key, strlen(key))));
+	}
+	EXPECT_EQ_SIZE_T(101, lept_find_object_index(&v, "", 0));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "k100", 4));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "k1", 1));
+	lept_free(&v);
+}
+
+#define TEST_STRINGIFY_VALUE(expect, v)\
+    do {\
+        char* json;\
+        size_t length;\
+        EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(v, &json, &length));\
+        EXPECT_EQ_STRING(expect, json, length);\
+        free(json);\
+    } while(0)
+
+static void test_access_array() {
+	lept_value a, e;
+	size_t i;
+
+	lept_init(&a);
+	lept_set_array(&a, 0);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_capacity(&a));
+	for (i = 0; i < 10; i++)
+		lept_set_number(lept_pushback_array_element(&a), (double)i);
+	EXPECT_EQ_SIZE_T(10, lept_get_array_size(&a));
+	EXPECT_TRUE(lept_get_array_capacity(&a) >= 10);
+	TEST_STRINGIFY_VALUE("[0,1,2,3,4,5,6,7,8,9]", &a);
+
+	lept_popback_array_element(&a);
+	lept_erase_array_element(&a, 4, 2);
+	lept_erase_array_element(&a, 0, 0);
+	lept_set_string(lept_insert_array_element(&a, 0), "head", 4);
+	lept_set_boolean(lept_insert_array_element(&a, lept_get_array_size(&a)), 1);
+	TEST_STRINGIFY_VALUE("[\"head\",0,1,2,3,6,7,8,true]", &a);
+
+	lept_reserve_array(&a, 100);
+	EXPECT_EQ_SIZE_T(100, lept_get_array_capacity(&a));
+	lept_reserve_array(&a, 10);
+	EXPECT_EQ_SIZE_T(100, lept_get_array_capacity(&a));
+	lept_shrink_array(&a);
+	EXPECT_EQ_SIZE_T(9, lept_get_array_capacity(&a));
+	EXPECT_FALSE(a.flags & LEPT_FLAG_CAPACITY);
+	lept_clear_array(&a);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_size(&a));
+	lept_shrink_array(&a);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_capacity(&a));
+	lept_free(&a);
+
+	/* Ҳ޸ģԪػ */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&a, "[1,[2,\"x\"],3]"));
+	EXPECT_EQ_SIZE_T(3, lept_get_array_capacity(&a));
+	lept_init(&e);
+	lept_set_array(&e, 2);
+	lept_set_null(lept_pushback_array_element(&e));
+	*lept_pushback_array_element(lept_get_array_element(&a, 1)) = e; /* תƸaeͷ */
+	lept_erase_array_element(&a, 0, 1);
+	lept_set_string(lept_pushback_array_element(&a), "a somewhat longer string", 24);
+	TEST_STRINGIFY_VALUE("[[2,\"x\",[null]],3,\"a somewhat longer string\"]", &a);
+	lept_free(&a);
+}
+
+static void test_access_object() {
+	lept_value o, *v;
+	char json[2048], key[32];
+	size_t i;
+	lept_intern t;
+
+	lept_init(&o);
+	lept_set_object(&o, 0);
+	EXPECT_EQ_SIZE_T(0, lept_get_object_capacity(&o));
+	/* ӵLEPT_OBJECT_INDEX_MINԱ;ɴϣĲ */
+	for (i = 0; i < 100; i++) {
+		sprintf(key, i % 2 ? "k%d" : "a rather long key %d", (int)i);
+		lept_set_number(lept_set_object_value(&o, key, strlen(key)), (double)i);
+	}
+	EXPECT_EQ_SIZE_T(100, lept_get_object_size(&o));
+	EXPECT_TRUE(o.flags & LEPT_FLAG_INDEXED);
+	for (i = 0; i < 100; i++) {
+		sprintf(key, i % 2 ? "k%d" : "a rather long key %d", (int)i);
+		EXPECT_EQ_SIZE_T(i, lept_find_object_index(&o, key, strlen(key)));
+	}
+	/* еļԭֵ */
+	v = lept_set_object_value(&o, "k7", 2);
+	EXPECT_EQ_DOUBLE(7.0, lept_get_number(v));
+	EXPECT_EQ_SIZE_T(100, lept_get_object_size(&o));
+
+	lept_remove_object_value(&o, 0);
+	lept_remove_object_value(&o, lept_find_object_index(&o, "k7", 2));
+	EXPECT_EQ_SIZE_T(98, lept_get_object_size(&o));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&o, "k7", 2));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&o, "a rather long key 0", 19));
+	EXPECT_EQ_DOUBLE(99.0, lept_get_number(lept_find_object_value(&o, "k99", 3)));
+
+	lept_shrink_object(&o);
+	EXPECT_EQ_SIZE_T(98, lept_get_object_capacity(&o));
+	EXPECT_TRUE(o.flags & LEPT_FLAG_INDEXED);
+	EXPECT_EQ_DOUBLE(98.0, lept_get_number(lept_find_object_value(&o, "a rather long key 98", 20)));
+	lept_clear_object(&o);
+	EXPECT_EQ_SIZE_T(0, lept_get_object_size(&o));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&o, "k99", 3));
+	EXPECT_EQ_SIZE_T(98, lept_get_object_capacity(&o));
+	lept_shrink_object(&o);
+	EXPECT_EQ_SIZE_T(0, lept_get_object_capacity(&o));
+	lept_set_null(lept_set_object_value(&o, "", 0));
+	lept_reserve_object(&o, 20);
+	EXPECT_EQ_SIZE_T(20, lept_get_object_capacity(&o));
+	TEST_STRINGIFY_VALUE("{\"\":null}", &o);
+	lept_free(&o);
+
+	/* ԭؽļǽõģפļǹõģ޸֮󶼻Լһ */
+	strcpy(json, "{\"customer_id\":1,\"b\":[true]}");
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&o, json));
+	lept_set_number(lept_set_object_value(&o, "c", 1), 3.0);
+	memset(json, 0, sizeof(json));
+	TEST_STRINGIFY_VALUE("{\"customer_id\":1,\"b\":[true],\"c\":3}", &o);
+	lept_free(&o);
+
+	strcpy(json, "{");
+	for (i = 0; i < 40; i++)
+		sprintf(json + strlen(json), "%s\"key_number_%d\":%d", i ? "," : "", (int)i, (int)i);
+	strcat(json, "}");
+	lept_intern_init(&t);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_intern(&o, json, strlen(json), &t));
+	lept_remove_object_value(&o, 3);
+	EXPECT_FALSE(o.flags & LEPT_FLAG_INTERNED);
+	lept_intern_free(&t);
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&o, "key_number_3", 12));
+	EXPECT_EQ_DOUBLE(39.0, lept_get_number(lept_find_object_value(&o, "key_number_39", 13)));
+	lept_free(&o);
+
+	/* ֵ޸֮ǰչ */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&o, "{\"a\":[1,2],\"b\":{}}", 18));
+	lept_set_number(lept_pushback_array_element(lept_find_object_value(&o, "a", 1)), 3.0);
+	lept_set_string(lept_set_object_value(lept_find_object_value(&o, "b", 1), "x", 1), "y", 1);
+	TEST_STRINGIFY_VALUE("{\"a\":[1,2,3],\"b\":{\"x\":\"y\"}}", &o);
+	lept_free(&o);
+}
+
+// SAXԣ¼¼һַ
+typedef struct {
+	char log[256];
+	int stop_at; // ڼ¼0
+	int count;
+} sax_recorder;
+
+static int sax_log(void* user, const char* s) {
+	sax_recorder* r = (sax_recorder*)user;
+	strcat(r->log, s);
+	return ++r->count != r->stop_at;
+}
+static int sax_null(void* user) { return sax_log(user, "n"); }
+static int sax_boolean(void* user, int b) { return sax_log(user, b ? "t" : "f"); }
+static int sax_number(void* user, double n) { char buf[32]; sprintf(buf, "%g", n); return sax_log(user, buf); }
+static int sax_string(void* user, const char* s, size_t len) {
+	char buf[64];
+	sprintf(buf, "'%s'%d", s, (int)len);
+	return sax_log(user, buf);
+}
+static int sax_start_array(void* user) { return sax_log(user, "["); }
+static int sax_end_array(void* user, size_t count) { char buf[32]; sprintf(buf, "]%d", (int)count); return sax_log(user, buf); }
+static int sax_start_object(void* user) { return sax_log(user, "{"); }
+static int sax_key(void* user, const char* k, size_t klen) { char buf[64]; sprintf(buf, "%.*s:", (int)klen, k); return sax_log(user, buf); }
+static int sax_end_object(void* user, size_t count) { char buf[32]; sprintf(buf, "}%d", (int)count); return sax_log(user, buf); }
+
+static const lept_sax_handler sax_handler = {
+	sax_null, sax_boolean, sax_number, sax_string, sax_start_array, sax_end_array, sax_start_object, sax_key, sax_end_object
+};
+
+#define TEST_SAX(expect_ret, expect_log, stop, json)\
+    do {\
+        sax_recorder r;\
+        r.log[0] = '\0';\
+        r.stop_at = stop;\
+        r.count = 0;\
+        EXPECT_EQ_INT(expect_ret, lept_parse_sax(json, &sax_handler, &r));\
+        EXPECT_EQ_STRING(expect_log, r.log, strlen(r.log));\
+    } while(0)
+
+static void test_parse_sax() {
+	lept_sax_handler empty;
+	TEST_SAX(LEPT_PARSE_OK, "n", 0, " null ");
+	TEST_SAX(LEPT_PARSE_OK, "[]0", 0, "[ ]");
+	TEST_SAX(LEPT_PARSE_OK, "{}0", 0, "{ }");
+	TEST_SAX(LEPT_PARSE_OK, "{a:[tf1.5'x\n'2{}0]5b:n}2", 0, "{\"a\":[true,false,1.5,\"x\\n\",{}],\"b\":null}");
+	TEST_SAX(LEPT_PARSE_ABORTED, "{a:[t", 4, "{\"a\":[true,false,1.5,\"x\\n\",{}],\"b\":null}");
+	/* lept_parseһ֮ǰ¼Ѿ */
+	TEST_SAX(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, "[1", 0, "[1}");
+	TEST_SAX(LEPT_PARSE_MISS_COLON, "{a:", 0, "{\"a\"}");
+	TEST_SAX(LEPT_PARSE_INVALID_VALUE, "[1", 0, "[1,]");
+	TEST_SAX(LEPT_PARSE_ROOT_NOT_SINGULAR, "n", 0, "null x");
+	TEST_SAX(LEPT_PARSE_EXPECT_VALUE, "", 0, "");
+
+	/* ûлصʱֻ﷨ */
+	memset(&empty, 0, sizeof(empty));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_sax("{\"a\":[1,2,{\"b\":\"c\"}]}", &empty, NULL));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_KEY, lept_parse_sax("{1:2}", &empty, NULL));
+}
+
+static void test_parse_n() {
+	lept_value v;
+	// 󻺳еһΣݲӰ
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, "123456", 3));
+	EXPECT_EQ_DOUBLE(123.0, lept_get_number(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, "[1,2] trailing", 5));
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, "\"abc\"\"def\"", 5));
+	EXPECT_EQ_STRING("abc", lept_get_string(&v), lept_get_string_length(&v));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, lept_parse_n(&v, "null", 0));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parse_n(&v, "null", 3));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parse_n(&v, "1.5", 2));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_QUOTATION_MARK, lept_parse_n(&v, "\"abc\"", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_ESCAPE, lept_parse_n(&v, "\"\\n\"", 2));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_UNICODE_HEX, lept_parse_n(&v, "\"\\u0041\"", 6));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_UNICODE_SURROGATE, lept_parse_n(&v, "\"\\uD834\\uDD1E\"", 8));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_n(&v, "[1,2]", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_n(&v, "{\"a\":1}", 6));
+
+	// ڵ'\0'ֻֽͨ
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_CHAR, lept_parse_n(&v, "\"a\0b\"", 5));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parse_n(&v, "[1]\0", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parse_n(&v, "\0", 1));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_n(&v, "[1\0]", 4));
+
+	// βɨĿм
+	EXPECT_EQ_INT(LEPT_PARSE_OK, parse_exact(&v, "\"0123456789abcdef0123456789abcdef0123\"   ", 41));
+	EXPECT_EQ_SIZE_T(36, lept_get_string_length(&v));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_QUOTATION_MARK, parse_exact(&v, "\"0123456789abcdef0123456789abcdef0123", 37));
+	EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, parse_exact(&v, "                                         ", 41));
+}
+
+static void test_parse_file() {
+	const char* path = "lept_test.json";
+	lept_value v;
+	FILE* fp;
+
+	fp = fopen(path, "wb");
+	fputs(" { \"a\" : [ 1, \"x\\ny\" ], \"b\" : null } ", fp);
+	fclose(fp);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_file(&v, path));
+	EXPECT_EQ_SIZE_T(2, lept_get_object_size(&v));
+	EXPECT_EQ_STRING("x\ny", lept_get_string(lept_get_array_element(lept_find_object_value(&v, "a", 1), 1)), 3);
+	lept_free(&v);
+
+	// ļݾjsonû'\0'
+	fp = fopen(path, "wb");
+	fputs("[1,2", fp);
+	fclose(fp);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_file(&v, path));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+
+	fp = fopen(path, "wb");
+	fclose(fp);
+	EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, lept_parse_file(&v, path));
+
+	remove(path);
+	EXPECT_EQ_INT(LEPT_FILE_ERROR, lept_parse_file(&v, path));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+}
+
+// ǰ油070ոÿλö64ֽڿı߽ϣҪlept_parse_nһ
+static void test_parse_structural() {
+	static const char* jsons[] = {
+		"{\"a\\\\\\\"b\":[1,\"x\\\"y\",true,null,-1.5e3,\"\\u00e9\\uD834\\uDD1E\"],\"k\":{},\"l\":[]}",
+		"[\"\\\\\", \"\\\\\\\\\", \"\\\\\\\\\\\\\", \"{[:,]}\"]",
+		"[1 2]", "[1,]", "{\"a\" 1}", "{\"a\":1,}", "{1:2}", "12a", "[nul]", "[true false]", "\"abc\"x",
+		"[\"a\\qb\"]", "[\"\x01\"]", "[\"abc", "\"\\", "[1]]", "[[1]", "{\"a\":1}}", "\\\"x\"", "[1e309]", "[\"a\"]x", " ", "-",
+		"[1\f2]", "[1\x1a 2]", "[1,\x1a" "2]", "{\"a\"\f:1}", "{\"a\"\x1a:1}", "[1\f,2]"
+	};
+	char buf[256];
+	lept_value v;
+	size_t i, j, len;
+	for (i = 0; i < sizeof(jsons) / sizeof(jsons[0]); i++)
+		for (j = 0; j <= 70; j++) {
+			memset(buf, ' ', j);
+			len = strlen(jsons[i]);
+			memcpy(buf + j, jsons[i], len);
+			parse_exact(&v, buf, j + len);
+			lept_free(&v);
+		}
+}
+
+static void test_parse_lazy() {
+	const char* json = " { \"n\" : 1.5 , \"s\" : \"a\\u00e9b\" , \"a\" : [ [ \"x\" ] , { \"k\" : \"]\\\"}\" } , true ] , \"o\" : { \"p\" : null } } ";
+	lept_value v, *a, *e;
+	size_t i;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, json, strlen(json)));
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(&v));
+	EXPECT_TRUE(v.flags & LEPT_FLAG_LAZY);
+	// һԱֻչһ㣬Ա
+	EXPECT_EQ_SIZE_T(4, lept_get_object_size(&v));
+	EXPECT_FALSE(v.flags & LEPT_FLAG_LAZY);
+	EXPECT_EQ_DOUBLE(1.5, lept_get_number(lept_find_object_value(&v, "n", 1)));
+	e = lept_find_object_value(&v, "s", 1);
+	EXPECT_EQ_INT(LEPT_STRING, lept_get_type(e));
+	EXPECT_TRUE(e->flags & LEPT_FLAG_LAZY);
+	EXPECT_EQ_STRING("a\xC3\xA9" "b", lept_get_string(e), lept_get_string_length(e));
+	EXPECT_FALSE(e->flags & LEPT_FLAG_LAZY);
+	a = lept_find_object_value(&v, "a", 1);
+	EXPECT_TRUE(a->flags & LEPT_FLAG_LAZY);
+	EXPECT_EQ_SIZE_T(3, lept_get_array_size(a));
+	e = lept_get_array_element(a, 1);
+	EXPECT_TRUE(e->flags & LEPT_FLAG_LAZY);
+	EXPECT_EQ_STRING("]\"}", lept_get_string(lept_find_object_value(e, "k", 1)), 3);
+	EXPECT_TRUE(lept_get_array_element(a, 0)->flags & LEPT_FLAG_LAZY);
+	EXPECT_TRUE(lept_find_object_value(&v, "o", 1)->flags & LEPT_FLAG_LAZY);
+	// ͷһֻչһֵ
+	lept_free(&v);
+
+	// ȫչ֮lept_parseһ
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, json, strlen(json)));
+	lept_get_array_size(lept_find_object_value(&v, "a", 1));
+	lept_expand(&v);
+	for (i = 0; i < lept_get_object_size(&v); i++)
+		EXPECT_FALSE(lept_get_object_value(&v, i)->flags & LEPT_FLAG_LAZY);
+	EXPECT_FALSE(lept_get_array_element(lept_find_object_value(&v, "a", 1), 0)->flags & LEPT_FLAG_LAZY);
+	lept_free(&v);
+
+	// ﷨ڽʱͱ
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_ESCAPE, lept_parse_lazy(&v, "[1,{\"a\":[\"\\x\"]}]", 15));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_NUMBER_TOO_BIG, lept_parse_lazy(&v, "[[1e309]]", 9));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, "12", 2));
+	EXPECT_EQ_DOUBLE(12.0, lept_get_number(&v));
+}
+
+static void test_parse_tape() {
+	const char* json = "{\"n\":1.5,\"s\":\"a\\u0000b\",\"a\":[[\"x\"],{},true,false,null,[]],\"o\":{\"p\":-2}}";
+	lept_tape t;
+	lept_value v;
+	size_t a, e, o, i, n;
+	lept_tape_init(&t);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_tape(&t, json, strlen(json)));
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_tape_get_type(&t, 0));
+	EXPECT_EQ_SIZE_T(4, lept_tape_get_object_size(&t, 0));
+	EXPECT_EQ_SIZE_T(t.size, lept_tape_next(&t, 0));
+	EXPECT_EQ_STRING("s", lept_tape_get_object_key(&t, 0, 1), lept_tape_get_object_key_length(&t, 0, 1));
+	EXPECT_EQ_DOUBLE(1.5, lept_tape_get_number(&t, lept_tape_get_object_value(&t, 0, 0)));
+	e = lept_tape_find_object_value(&t, 0, "s", 1);
+	EXPECT_EQ_STRING("a\0b", lept_tape_get_string(&t, e), lept_tape_get_string_length(&t, e));
+	a = lept_tape_find_object_value(&t, 0, "a", 1);
+	EXPECT_EQ_SIZE_T(6, lept_tape_get_array_size(&t, a));
+	e = lept_tape_get_array_element(&t, a, 0);
+	EXPECT_EQ_INT(LEPT_ARRAY, lept_tape_get_type(&t, e));
+	EXPECT_EQ_STRING("x", lept_tape_get_string(&t, lept_tape_get_array_element(&t, e, 0)), 1);
+	EXPECT_EQ_SIZE_T(0, lept_tape_get_object_size(&t, lept_tape_get_array_element(&t, a, 1)));
+	EXPECT_TRUE(lept_tape_get_boolean(&t, lept_tape_get_array_element(&t, a, 2)));
+	EXPECT_FALSE(lept_tape_get_boolean(&t, lept_tape_get_array_element(&t, a, 3)));
+	EXPECT_EQ_INT(LEPT_NULL, lept_tape_get_type(&t, lept_tape_get_array_element(&t, a, 4)));
+	EXPECT_EQ_SIZE_T(0, lept_tape_get_array_size(&t, lept_tape_get_array_element(&t, a, 5)));
+	// lept_tape_next˳һ
+	for (i = 0, n = 0, e = a + 2; i < lept_tape_get_array_size(&t, a); i++, e = lept_tape_next(&t, e))
+		n++;
+	EXPECT_EQ_SIZE_T(6, n);
+	o = lept_tape_find_object_value(&t, 0, "o", 1);
+	EXPECT_EQ_SIZE_T(e, o - 1);
+	EXPECT_EQ_DOUBLE(-2.0, lept_tape_get_number(&t, lept_tape_find_object_value(&t, o, "p", 1)));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_tape_find_object_value(&t, 0, "x", 1));
+
+	// תֻתһҲ
+	lept_tape_to_value(&t, o, &v);
+	EXPECT_EQ_DOUBLE(-2.0, lept_get_number(lept_find_object_value(&v, "p", 1)));
+	lept_free(&v);
+
+	// ʧܵʱtapeǿյģ
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_tape(&t, "[1,{\"a\":[2 3]}]", 16));
+	EXPECT_EQ_SIZE_T(0, t.size);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_tape(&t, " 7 ", 3));
+	EXPECT_EQ_DOUBLE(7.0, lept_tape_get_number(&t, 0));
+	lept_tape_free(&t);
+}
+
+typedef struct {
+	char* city;
+	double zip;
+} test_address;
+
+typedef struct {
+	double id;
+	char* name;
+	int active;
+	test_address address;
+	lept_value tags;
+	lept_value extra;
+} test_user;
+
+static const lept_field test_address_fields[] = {
+	{ "city", offsetof(test_address, city), LEPT_STRING, NULL },
+	{ "zip", offsetof(test_address, zip), LEPT_NUMBER, NULL },
+	{ NULL, 0, LEPT_NULL, NULL }
+};
+
+static const lept_field test_user_fields[] = {
+	{ "id", offsetof(test_user, id), LEPT_NUMBER, NULL },
+	{ "name", offsetof(test_user, name), LEPT_STRING, NULL },
+	{ "active", offsetof(test_user, active), LEPT_TRUE, NULL },
+	{ "address", offsetof(test_user, address), LEPT_OBJECT, test_address_fields },
+	{ "tags", offsetof(test_user, tags), LEPT_ARRAY, NULL },
+	{ "extra", offsetof(test_user, extra), LEPT_NULL, NULL },
+	{ NULL, 0, LEPT_NULL, NULL }
+};
+
+#define TEST_INTO_ERROR(error, json)\
+    do {\
+        test_user u;\
+        memset(&u, 0, sizeof(u));\
+        EXPECT_EQ_INT(error, lept_parse_into(&u, test_user_fields, json, strlen(json)));\
+        EXPECT_TRUE(u.name == NULL && u.address.city == NULL && lept_get_type(&u.tags) == LEPT_NULL);\
+    } while(0)
+
+static void test_parse_into() {
+	const char* json = " { \"active\" : true, \"name\" : \"a\\u00e9\", \"skip\" : {\"x\":[1,{\"y\":\"z\"}]}, \"id\" : 42,"
+		" \"address\" : { \"zip\" : 10001, \"city\" : \"NYC\", \"street\" : \"5th\" }, \"tags\" : [\"a\", 1], \"extra\" : {\"k\":null},"
+		" \"name\" : \"bob\", \"id\" : null } ";
+	test_user u;
+	memset(&u, 0, sizeof(u));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_into(&u, test_user_fields, json, strlen(json)));
+	EXPECT_EQ_DOUBLE(42.0, u.id); // null
+	EXPECT_EQ_STRING("bob", u.name, strlen(u.name)); // ظļĸǰ
+	EXPECT_EQ_INT(1, u.active);
+	EXPECT_EQ_STRING("NYC", u.address.city, strlen(u.address.city));
+	EXPECT_EQ_DOUBLE(10001.0, u.address.zip);
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&u.tags));
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(&u.extra));
+	lept_free_into(&u, test_user_fields);
+	EXPECT_TRUE(u.name == NULL && u.address.city == NULL);
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&u.tags));
+
+	TEST_INTO_ERROR(LEPT_PARSE_TYPE_MISMATCH, "{\"name\":\"x\",\"id\":\"42\"}");
+	TEST_INTO_ERROR(LEPT_PARSE_TYPE_MISMATCH, "{\"address\":{\"city\":\"x\"},\"tags\":{}}");
+	TEST_INTO_ERROR(LEPT_PARSE_TYPE_MISMATCH, "{\"active\":1}");
+	TEST_INTO_ERROR(LEPT_PARSE_TYPE_MISMATCH, "[1]");
+	TEST_INTO_ERROR(LEPT_PARSE_INVALID_VALUE, "{\"id\":tru}");
+	TEST_INTO_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "{\"name\":\"x\",\"id\":1e309}");
+	TEST_INTO_ERROR(LEPT_PARSE_INVALID_STRING_ESCAPE, "{\"name\":\"x\",\"skip\":[\"\\x\"]}");
+	TEST_INTO_ERROR(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"address\":{\"city\":\"x\" \"zip\":1}}");
+	TEST_INTO_ERROR(LEPT_PARSE_MISS_COLON, "{\"name\" \"x\"}");
+	TEST_INTO_ERROR(LEPT_PARSE_MISS_KEY, "{\"tags\":[1],}");
+	TEST_INTO_ERROR(LEPT_PARSE_ROOT_NOT_SINGULAR, "{\"name\":\"x\"} x");
+	TEST_INTO_ERROR(LEPT_PARSE_EXPECT_VALUE, " ");
+}
+
+typedef struct {
+	size_t count, last, stop_at;
+	unsigned char* seen;
+	int bad;
+} ndjson_recorder;
+
+// k¼{"i":k}k % 1000 == 999Щ'}'
+static int ndjson_ordered(void* user, size_t offset, int ret, lept_value* v) {
+	ndjson_recorder* r = (ndjson_recorder*)user;
+	if (r->count && offset <= r->last)
+		r->bad = 1;
+	if (ret == LEPT_PARSE_OK ? lept_get_number(lept_find_object_value(v, "i", 1)) != (double)r->count
+		: ret != LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET || lept_get_type(v) != LEPT_NULL || r->count % 1000 != 999)
+		r->bad = 1;
+	r->last = offset;
+	return ++r->count != r->stop_at;
+}
+
+// ڼ߳ͬʱãÿ¼offsetһֻдԼһ
+static int ndjson_unordered(void* user, size_t offset, int ret, lept_value* v) {
+	ndjson_recorder* r = (ndjson_recorder*)user;
+	r->seen[offset] = ret == LEPT_PARSE_OK && lept_get_type(v) == LEPT_OBJECT ? 1 : 2;
+	return 1;
+}
+
+static void test_parse_ndjson() {
+	const char* path = "lept_test.ndjson";
+	static const int threads[] = { 1, 4, 0 };
+	const size_t n = 60000;
+	ndjson_recorder r;
+	char* json = (char*)malloc(n * 20);
+	size_t i, len = 0, good = 0, bad = 0;
+	FILE* fp;
+	for (i = 0; i < n; i++) {
+		len += sprintf(json + len, i % 1000 == 999 ? "{\"i\":%u" : "{\"i\":%u}", (unsigned)i);
+		if (i + 1 < n)
+			len += sprintf(json + len, i % 500 == 0 ? "\n  \r\n\n" : "\n");
+	}
+
+	for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+		memset(&r, 0, sizeof(r));
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ndjson(json, len, threads[i], 1, ndjson_ordered, &r));
+		EXPECT_EQ_SIZE_T(n, r.count);
+		EXPECT_EQ_INT(0, r.bad);
+	}
+
+	memset(&r, 0, sizeof(r));
+	r.seen = (unsigned char*)calloc(len, 1);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ndjson(json, len, 4, 0, ndjson_unordered, &r));
+	for (i = 0; i < len; i++) {
+		good += r.seen[i] == 1;
+		bad += r.seen[i] == 2;
+	}
+	EXPECT_EQ_SIZE_T(n - n / 1000, good);
+	EXPECT_EQ_SIZE_T(n / 1000, bad);
+	free(r.seen);
+
+	// صҪֹͣļ¼ٽ
+	memset(&r, 0, sizeof(r));
+	r.stop_at = 1500;
+	EXPECT_EQ_INT(LEPT_PARSE_ABORTED, lept_parse_ndjson(json, len, 4, 1, ndjson_ordered, &r));
+	EXPECT_EQ_SIZE_T(1500, r.count);
+
+	memset(&r, 0, sizeof(r));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ndjson("", 0, 4, 1, ndjson_ordered, &r));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ndjson(" \n\n", 3, 4, 1, ndjson_ordered, &r));
+	EXPECT_EQ_SIZE_T(0, r.count);
+
+	fp = fopen(path, "wb");
+	fwrite(json, 1, len, fp);
+	fclose(fp);
+	memset(&r, 0, sizeof(r));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ndjson_file(path, 2, 1, ndjson_ordered, &r));
+	EXPECT_EQ_SIZE_T(n, r.count);
+	EXPECT_EQ_INT(0, r.bad);
+	remove(path);
+	EXPECT_EQ_INT(LEPT_FILE_ERROR, lept_parse_ndjson_file(path, 2, 1, ndjson_ordered, &r));
+	free(json);
+}
+
+// chunkֽһιȥʹҪlept_parseһ
+static void test_feed_chunked(lept_parser* p, const char* json, size_t chunk) {
+	lept_value v, expect;
+	char *s1, *s2;
+	size_t len = strlen(json), i, n1, n2;
+	int ret, expect_ret = lept_parse(&expect, json);
+	for (i = 0; i < len; i += chunk)
+		lept_parser_feed(p, json + i, len - i < chunk ? len - i : chunk);
+	ret = lept_parser_finish(p, &v);
+	EXPECT_EQ_INT(expect_ret, ret);
+	lept_free(&v);
+	// ׶νҲҪһ
+	parse_exact(&v, json, len);
+	lept_free(&v);
+	for (i = 0; i < len; i += chunk)
+		lept_parser_feed(p, json + i, len - i < chunk ? len - i : chunk);
+	ret = lept_parser_finish(p, &v);
+	if (expect_ret == LEPT_PARSE_OK && ret == LEPT_PARSE_OK) {
+		lept_stringify(&expect, &s1, &n1);
+		lept_stringify(&v, &s2, &n2);
+		EXPECT_EQ_SIZE_T(n1, n2);
+		EXPECT_TRUE(n1 == n2 && memcmp(s1, s2, n1) == 0);
+		free(s1);
+		free(s2);
+	}
+	else
+		EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	lept_free(&v);
+	lept_free(&expect);
+}
+
+static void test_parser_feed() {
+	static const char* jsons[] = {
+		"null", " true ", "false", "nul", "tru", "?", "", "  ",
+		"0", "-0.0", "123", "1.5e+10", "-1E-10", "1e309", "0123", "1.", "-", "1e", "1e+", ".5", "+1",
+		"\"\"", "\"Hello\\nWorld\"", "\"\\u00A2\\u20AC\\uD834\\uDD1E\"", "\"\\\" \\\\ \\/ \\b \\f \\r \\t\"",
+		"\"abc", "\"\\v\"", "\"\x01\"", "\"\\u12\"", "\"\\uD800\"", "\"\\uD800\\uE000\"", "\"\\uD800\\u12G4\"",
+		"[ ]", "[ null , false , true , 123 , \"abc\" ]", "[ [ ] , [ 0 ] , [ 0 , 1 ] , [ 0 , 1 , 2 ] ]", "[1", "[1}", "[1,]", "[[]",
+		" { \"n\" : null , \"a\" : [ 1, 2, 3 ], \"o\" : { \"1\" : 1, \"2\" : 2 } } ",
+		"{\"a\"}", "{\"a\":1", "{\"a\":1 \"b\"", "{1:1}", "{\"a\":1,}", "{\"a\":{}", "{} x", "[\"a\", {\"b\": [\"c\"",
+		"{\"k00\":0,\"k01\":1,\"k02\":2,\"k03\":3,\"k04\":4,\"k05\":5,\"k06\":6,\"k07\":7,"
+		"\"k08\":8,\"k09\":9,\"k10\":10,\"k11\":11,\"k12\":12,\"k13\":13,\"k14\":14,\"k15\":15,\"k16\":16}"
+	};
+	static const size_t chunks[] = { 1, 2, 3, 7, 1000 };
+	lept_parser p;
+	lept_value v;
+	size_t i, j;
+	lept_parser_init(&p);
+	for (i = 0; i < sizeof(jsons) / sizeof(jsons[0]); i++)
+		for (j = 0; j < sizeof(chunks) / sizeof(chunks[0]); j++)
+			test_feed_chunked(&p, jsons[i], chunks[j]);
+
+	// ֮ιҲǸ
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_KEY, lept_parser_feed(&p, "{1", 2));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_KEY, lept_parser_feed(&p, "}", 1));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_KEY, lept_parser_finish(&p, &v));
+
+	// ҲҪ
+	lept_parser_feed(&p, jsons[i - 1], strlen(jsons[i - 1]));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_finish(&p, &v));
+	EXPECT_EQ_SIZE_T(16, lept_find_object_index(&v, "k16", 3));
+	lept_free(&v);
+
+	// е'\0'ֽһǽβlept_parse_nһ
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parser_feed(&p, "12\0,", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parser_finish(&p, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parse_n(&v, "12\0,", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_CHAR, lept_parser_feed(&p, "\"a\0b\"", 5));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_CHAR, lept_parser_finish(&p, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parser_feed(&p, "\0", 1));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parser_finish(&p, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_feed(&p, "[1, ", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parser_feed(&p, "\0]", 2));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parser_finish(&p, &v));
+
+	// ϵֵˣfeedǿհҲǴ
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_feed(&p, "[1] ", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_feed(&p, " \n", 2));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parser_feed(&p, "\0", 1));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parser_finish(&p, &v));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_feed(&p, "true", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parser_feed(&p, "x", 1));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parser_finish(&p, &v));
+
+	// һͷ
+	lept_parser_feed(&p, "[{\"a\":[\"x\",\"y", 14);
+	lept_parser_free(&p);
+}
+
+// nǶ׵飬inner
+static char* make_nested(size_t n, const char* inner) {
+	size_t len = strlen(inner);
+	char* s = (char*)malloc(2 * n + len + 1);
+	memset(s, '[', n);
+	memcpy(s + n, inner, len);
+	memset(s + n + len, ']', n);
+	s[2 * n + len] = '\0';
+	return s;
+}
+
+static void test_parse_depth() {
+	lept_value v;
+	lept_parser p;
+	lept_sax_handler h;
+	char *json, *out;
+	size_t length;
+
+	json = make_nested(LEPT_PARSE_MAX_DEPTH, "");
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	lept_free(&v);
+	free(json);
+	json = make_nested(LEPT_PARSE_MAX_DEPTH + 1, "");
+	TEST_ERROR(LEPT_PARSE_DEPTH_EXCEEDED, json);
+	memset(&h, 0, sizeof(h));
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_sax(json, &h, NULL));
+	free(json);
+	// ֮ǰѾĲֶҪͷ
+	json = make_nested(LEPT_PARSE_MAX_DEPTH, "{\"a\":[\"x\",{\"b\":[]}]}");
+	TEST_ERROR(LEPT_PARSE_DEPTH_EXCEEDED, json);
+	free(json);
+	json = make_nested(100000, "");
+	TEST_ERROR(LEPT_PARSE_DEPTH_EXCEEDED, json);
+
+	// ſƣǶ׺Ҳͷźɣջ
+	lept_parser_init(&p);
+	p.max_depth = 100000;
+	lept_parser_feed(&p, json, strlen(json));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_finish(&p, &v));
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &out, &length));
+	EXPECT_EQ_SIZE_T(strlen(json), length);
+	EXPECT_TRUE(strcmp(json, out) == 0);
+	free(out);
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+
+	p.max_depth = 3;
+	lept_parser_feed(&p, "[[[[]]]]", 8);
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parser_finish(&p, &v));
+	lept_parser_feed(&p, "[[{}]]", 6);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_finish(&p, &v));
+	lept_free(&v);
+	lept_parser_free(&p);
+	free(json);
+}
+
+static void test_parser_parse() {
+	lept_parser p;
+	lept_value v;
+	char* big;
+	size_t i, size;
+	lept_parser_init(&p);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(&p, &v, "[\"abc\",{\"k\":1}]", 15));
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+	EXPECT_EQ_STRING("abc", lept_get_string(lept_get_array_element(&v, 0)), lept_get_string_length(lept_get_array_element(&v, 0)));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parser_parse(&p, &v, "[1 2]", 5));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parser_parse(&p, &v, "1 2", 3));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(&p, &v, "1 ", 1));
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(&v));
+
+	// ĵջ֮һֱСĵȥ
+	big = make_nested(LEPT_PARSE_MAX_DEPTH + 1, "");
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parser_parse(&p, &v, big, strlen(big)));
+	p.max_depth = LEPT_PARSE_MAX_DEPTH + 1;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(&p, &v, big, strlen(big)));
+	lept_free(&v);
+	size = p.size;
+	EXPECT_TRUE(size > 10000); // ÿҪ¸ڵͳԱ
+	for (i = 0; i < 2 * LEPT_SCRATCH_WINDOW; i++) {
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(&p, &v, "[\"x\",[]]", 8));
+		lept_free(&v);
+	}
+	EXPECT_TRUE(p.size < size / 2);
+	free(big);
+
+	// feedҲ
+	lept_parser_feed(&p, "[1,", 3);
+	lept_parser_feed(&p, "2]", 2);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_finish(&p, &v));
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(&p, &v, "true", 4));
+	EXPECT_EQ_INT(LEPT_TRUE, lept_get_type(&v));
+	lept_parser_free(&p);
+}
+
 static void test_parse_miss_key() {
 	TEST_ERROR(LEPT_PARSE_MISS_KEY, "{:1,");
 	TEST_ERROR(LEPT_PARSE_MISS_KEY, "{1:1,");
@@ -365,9 +1443,24 @@ static void test_parse_miss_comma_or_square_bracket() {
         EXPECT_EQ_STRING(json, json2, length);\
         lept_free(&v);\
         free(json2);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, parse_exact(&v, json, strlen(json)));\
+        lept_free(&v);\
     } while(0)
 
 
+// ɵĽ벻һʱ
+#define TEST_STRINGIFY(expect, json)\
+    do {\
+        lept_value v;\
+        char* json2;\
+        size_t length;\
+        lept_init(&v);\
+        EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));\
+        EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &json2, &length));\
+        EXPECT_EQ_STRING(expect, json2, length);\
+        lept_free(&v);\
+        free(json2);\
+    } while(0)
 
 static void test_stringify_number() {
 	TEST_ROUNDTRIP("0");
@@ -382,14 +1475,28 @@ static void test_stringify_number() {
 	TEST_ROUNDTRIP("1.234e-20");
 
 	TEST_ROUNDTRIP("1.0000000000000002"); /* the smallest number > 1 */
-	TEST_ROUNDTRIP("4.9406564584124654e-324"); /* minimum denormal */
-	TEST_ROUNDTRIP("-4.9406564584124654e-324");
-	TEST_ROUNDTRIP("2.2250738585072009e-308");  /* Max subnormal double */
-	TEST_ROUNDTRIP("-2.2250738585072009e-308");
+	TEST_STRINGIFY("5e-324", "4.9406564584124654e-324"); /* minimum denormal */
+	TEST_STRINGIFY("-5e-324", "-4.9406564584124654e-324");
+	TEST_STRINGIFY("2.225073858507201e-308", "2.2250738585072009e-308");  /* Max subnormal double */
+	TEST_STRINGIFY("-2.225073858507201e-308", "-2.2250738585072009e-308");
 	TEST_ROUNDTRIP("2.2250738585072014e-308");  /* Min normal positive double */
 	TEST_ROUNDTRIP("-2.2250738585072014e-308");
 	TEST_ROUNDTRIP("1.7976931348623157e+308");  /* Max double */
 	TEST_ROUNDTRIP("-1.7976931348623157e+308");
+
+	/* ̵ܻԭıʾԼͿѧķֽ */
+	TEST_ROUNDTRIP("0.1");
+	TEST_STRINGIFY("0.1", "0.10000000000000001");
+	TEST_ROUNDTRIP("0.3");
+	TEST_ROUNDTRIP("123.456");
+	TEST_ROUNDTRIP("0.0001");
+	TEST_ROUNDTRIP("1e-05");
+	TEST_ROUNDTRIP("1.5e-07");
+	TEST_ROUNDTRIP("9007199254740992");
+	TEST_ROUNDTRIP("10000000000000000");
+	TEST_ROUNDTRIP("1e+17");
+	TEST_STRINGIFY("123456789", "1.23456789e8");
+	TEST_STRINGIFY("1e+300", "1E300");
 }
 
 static void test_stringify_string() {
@@ -410,16 +1517,301 @@ static void test_stringify_object() {
 	TEST_ROUNDTRIP("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
 }
 
+// дļеҪlept_stringifyһҪдܶ
+static void test_stringify_file() {
+	lept_value v;
+	char *json, *buf, *p;
+	size_t length, n;
+	FILE* fp;
+	int i;
+	p = json = (char*)malloc(20000 * 40);
+	*p++ = '[';
+	for (i = 0; i < 20000; i++)
+		p += sprintf(p, "%s{\"k\":\"%.*s\\n\",\"n\":%d}", i ? "," : "", i % 11, "0123456789", i);
+	strcpy(p, "]");
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	free(json);
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &json, &length));
+
+	fp = tmpfile();
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_file(&v, fp));
+	EXPECT_EQ_SIZE_T(length, (size_t)ftell(fp));
+	rewind(fp);
+	buf = (char*)malloc(length + 1);
+	n = fread(buf, 1, length + 1, fp);
+	EXPECT_EQ_SIZE_T(length, n);
+	EXPECT_TRUE(memcmp(json, buf, length) == 0);
+	fclose(fp);
+	free(buf);
+	free(json);
+	lept_free(&v);
+}
+
+// ÿÿεĳ
+typedef struct {
+	char* s;
+	size_t len, calls, chunk, stop_at;
+	int bad_chunk;
+} sink_recorder;
+
+static int sink_write(void* user, const char* s, size_t len) {
+	sink_recorder* r = (sink_recorder*)user;
+	if (++r->calls == r->stop_at)
+		return 0;
+	if (len > r->chunk || (r->len % r->chunk) != 0) // ֻһοԲ
+		r->bad_chunk = 1;
+	r->s = (char*)realloc(r->s, r->len + len);
+	memcpy(r->s + r->len, s, len);
+	r->len += len;
+	return 1;
+}
+
+static void test_stringify_sink() {
+	static const char* jsons[] = {
+		"null", "\"a\\u0001b\"", "[1,2.5,\"abc\",{\"k\":[true,false]}]",
+		"{\"n\":null,\"s\":\"0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz\",\"o\":{\"1\":1}}"
+	};
+	static const size_t chunks[] = { 1, 3, 7, 64, 0 };
+	sink_recorder r;
+	lept_value v;
+	char* json;
+	size_t i, j, length;
+	for (i = 0; i < sizeof(jsons) / sizeof(jsons[0]); i++) {
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, jsons[i]));
+		lept_stringify(&v, &json, &length);
+		for (j = 0; j < sizeof(chunks) / sizeof(chunks[0]); j++) {
+			memset(&r, 0, sizeof(r));
+			r.chunk = chunks[j] ? chunks[j] : (size_t)-1;
+			EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_sink(&v, chunks[j], sink_write, &r));
+			EXPECT_EQ_SIZE_T(length, r.len);
+			EXPECT_TRUE(r.len == length && memcmp(r.s, json, length) == 0);
+			EXPECT_EQ_INT(0, r.bad_chunk);
+			free(r.s);
+		}
+		free(json);
+		lept_free(&v);
+	}
+
+	// ַܳҲǷֶ
+	lept_init(&v);
+	json = (char*)malloc(10000);
+	memset(json, 'x', 10000);
+	lept_set_string(&v, json, 10000);
+	free(json);
+	memset(&r, 0, sizeof(r));
+	r.chunk = 100;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_sink(&v, 100, sink_write, &r));
+	EXPECT_EQ_SIZE_T(10002, r.len);
+	EXPECT_EQ_SIZE_T(101, r.calls);
+	EXPECT_EQ_INT(0, r.bad_chunk);
+	free(r.s);
+	lept_free(&v);
+
+	// صͣ
+	lept_parse(&v, jsons[2]);
+	memset(&r, 0, sizeof(r));
+	r.chunk = 2;
+	r.stop_at = 3;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_ABORTED, lept_stringify_sink(&v, 2, sink_write, &r));
+	EXPECT_EQ_SIZE_T(3, r.calls);
+	free(r.s);
+	lept_free(&v);
+}
+
+// ַﵽҪתֶַεı߽ҲУͰҪֽתĽһ
+static void test_stringify_long_string() {
+	static const char* escapes[] = { "\\\"", "\\\\", "\\b", "\\f", "\\n", "\\r", "\\t" };
+	sink_recorder r;
+	lept_value v;
+	char *s, *expect, *json, *p;
+	size_t i, length;
+	s = (char*)malloc(10000);
+	p = expect = (char*)malloc(10000 * 6 + 2);
+	*p++ = '"';
+	for (i = 0; i < 10000; i++) {
+		s[i] = (i % 37 == 0 || i % 4096 == 4095 || i % 4096 == 0) ? (char)(i % 32) : (i % 53 == 0 ? '"' : (i % 61 == 0 ? '\\' : (char)('a' + i % 26)));
+		if (s[i] == '"')
+			p += sprintf(p, "%s", escapes[0]);
+		else if (s[i] == '\\')
+			p += sprintf(p, "%s", escapes[1]);
+		else if (s[i] == '\b' || s[i] == '\f' || s[i] == '\n' || s[i] == '\r' || s[i] == '\t')
+			p += sprintf(p, "%s", escapes[2 + (strchr("\b\f\n\r\t", s[i]) - "\b\f\n\r\t")]);
+		else if ((unsigned char)s[i] < 0x20)
+			p += sprintf(p, "\\u%04X", (unsigned char)s[i]);
+		else
+			*p++ = s[i];
+	}
+	*p++ = '"';
+	lept_init(&v);
+	lept_set_string(&v, s, 10000);
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &json, &length));
+	EXPECT_EQ_SIZE_T((size_t)(p - expect), length);
+	EXPECT_TRUE(length == (size_t)(p - expect) && memcmp(json, expect, length) == 0);
+	free(json);
+	memset(&r, 0, sizeof(r));
+	r.chunk = 100;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_sink(&v, 100, sink_write, &r));
+	EXPECT_TRUE(r.len == (size_t)(p - expect) && memcmp(r.s, expect, r.len) == 0);
+	EXPECT_EQ_INT(0, r.bad_chunk);
+	free(r.s);
+	lept_free(&v);
+	free(expect);
+	free(s);
+}
+
+// һ
+static void* test_max_alloc(void* user, size_t size) {
+	if (size > *(size_t*)user)
+		*(size_t*)user = size;
+	return malloc(size);
+}
+
+static void* test_max_resize(void* user, void* p, size_t size) {
+	if (size > *(size_t*)user)
+		*(size_t*)user = size;
+	return realloc(p, size);
+}
+
+static void test_max_release(void* user, void* p) {
+	(void)user;
+	free(p);
+}
+
+static void test_stringify_large_string() {
+	const size_t n = 1 << 20;
+	size_t max = 0, length;
+	lept_allocator a = { test_max_alloc, test_max_resize, test_max_release, NULL };
+	lept_value v;
+	char *s, *json;
+	a.user = &max;
+	s = (char*)malloc(n);
+	memset(s, 'a', n);
+	lept_init(&v);
+	lept_set_string(&v, s, n);
+	// 1.5ַܰ6Ԥ
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_with(&v, &json, &length, &a));
+	EXPECT_EQ_SIZE_T(n + 2, length);
+	EXPECT_TRUE(max < 2 * n);
+	EXPECT_TRUE(json[0] == '"' && json[n + 1] == '"' && json[n + 2] == '\0' && memcmp(json + 1, s, n) == 0);
+	a.release(a.user, json);
+	lept_free(&v);
+	free(s);
+}
+
+static void test_writer_stringify() {
+	lept_writer w;
+	lept_value v;
+	const char* json;
+	char* big;
+	size_t i, length, size;
+	lept_writer_init(&w);
+	lept_parse(&v, "[1,\"a\",{\"k\":null}]");
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_writer_stringify(&w, &v, &json, &length));
+	EXPECT_EQ_SIZE_T(18, length);
+	EXPECT_TRUE(strcmp("[1,\"a\",{\"k\":null}]", json) == 0);
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_writer_stringify(&w, &v, &json, NULL));
+	EXPECT_TRUE(strcmp("[1,\"a\",{\"k\":null}]", json) == 0);
+	lept_free(&v);
+
+	// һַ֮ܳ󣬶Ƕ̵ľȥ
+	big = (char*)malloc(100000);
+	memset(big, 'x', 100000);
+	lept_set_string(&v, big, 100000);
+	free(big);
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_writer_stringify(&w, &v, &json, &length));
+	EXPECT_EQ_SIZE_T(100002, length);
+	lept_free(&v);
+	size = w.size;
+	lept_set_boolean(&v, 1);
+	for (i = 0; i < 2 * LEPT_SCRATCH_WINDOW; i++) {
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_writer_stringify(&w, &v, &json, &length));
+		EXPECT_TRUE(length == 4 && strcmp("true", json) == 0);
+	}
+	EXPECT_TRUE(w.size < size / 2);
+	lept_free(&v);
+	lept_writer_free(&w);
+}
+
 static void test_stringify() {
 	TEST_ROUNDTRIP("null");
 	TEST_ROUNDTRIP("false");
 	TEST_ROUNDTRIP("true");
 	test_stringify_number();
 	test_stringify_string();
+	test_stringify_long_string();
+	test_stringify_large_string();
 	test_stringify_object();
 	test_stringify_array();
+	test_stringify_file();
+	test_stringify_sink();
+	test_writer_stringify();
 }
 
+#ifdef LEPT_STATS
+// ͳƳֵֽĸҪԵϣ̵߳ͳҲҪӻ
+static void test_stats() {
+	const char* json = " [1,\"a\",{\"k\":[true,false,null]},\"a long string value\"] ";
+	lept_parser p;
+	lept_stats s;
+	lept_value v;
+	ndjson_recorder r;
+	char* out;
+	size_t length;
+
+	lept_stats_reset();
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	lept_stats_get(&s);
+	EXPECT_EQ_SIZE_T(strlen(json), s.bytes);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_NULL]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_FALSE]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_TRUE]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_NUMBER]);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_STRING]);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_ARRAY]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_OBJECT]);
+	EXPECT_EQ_SIZE_T(3, s.max_depth);
+	EXPECT_EQ_SIZE_T(4, s.mallocs); // ַԱ顢Ԫ
+	EXPECT_TRUE(s.malloc_bytes > 0 && s.reallocs > 0 && s.stack_peak > 0);
+	EXPECT_EQ_SIZE_T(0, s.output_bytes);
+
+	lept_stats_reset();
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &out, &length));
+	lept_stats_get(&s);
+	EXPECT_EQ_SIZE_T(length, s.output_bytes);
+	EXPECT_EQ_SIZE_T(0, s.bytes);
+	free(out);
+	lept_free(&v);
+
+	// β'\0'
+	lept_stats_reset();
+	lept_parser_init(&p);
+	lept_parser_feed(&p, json, 10);
+	lept_parser_feed(&p, json + 10, strlen(json) - 10);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_finish(&p, &v));
+	lept_stats_get(&s);
+	EXPECT_EQ_SIZE_T(strlen(json), s.bytes);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_STRING]);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_ARRAY]);
+	EXPECT_EQ_SIZE_T(3, s.max_depth);
+	lept_free(&v);
+	lept_parser_free(&p);
+
+	lept_stats_reset();
+	memset(&r, 0, sizeof(r));
+	r.seen = (unsigned char*)calloc(40000, 1);
+	out = (char*)malloc(40000);
+	for (length = 0; length < 40000; length += 4)
+		memcpy(out + length, "[1]\n", 4);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ndjson(out, 40000, 4, 0, ndjson_unordered, &r));
+	lept_stats_get(&s);
+	EXPECT_EQ_SIZE_T(40000, s.bytes);
+	EXPECT_EQ_SIZE_T(10000, s.values[LEPT_ARRAY]);
+	EXPECT_EQ_SIZE_T(10000, s.values[LEPT_NUMBER]);
+	free(out);
+	free(r.seen);
+}
+#endif
+
 static void test_parse() {
 
 	test_access_boolean();
@@ -432,59 +1824,55 @@ static void test_parse() {
 	test_parse_number_too_big();
 	test_parse_number();
 	test_access_string();
+	test_parse_string();
+	test_short_string();
 	test_parse_missing_quotation_mark();
+	test_parse_invalid_string_escape();
+	test_parse_invalid_string_char();
 	test_parse_invalid_unicode_hex();
 	test_parse_invalid_unicode_surrogate();
 	test_parse_array();
 	test_parse_miss_comma_or_square_bracket();
 	test_parse_object();
+	test_parse_arena();
+	test_parse_insitu();
+	test_parse_intern();
+	test_parse_allocator();
+	test_find_object();
+	test_access_array();
+	test_access_object();
+	test_parse_sax();
+	test_parse_n();
+	test_parse_file();
+	test_parse_structural();
+	test_parse_lazy();
+	test_parse_tape();
+	test_parse_into();
+	test_parse_ndjson();
+	test_parser_feed();
+	test_parser_parse();
+	test_parse_depth();
 	test_parse_miss_comma_or_curly_bracket();
 	test_parse_miss_key();
 	test_parse_miss_colon();
 
 	test_stringify();
+#ifdef LEPT_STATS
+	test_stats();
+#endif
 
 }
 
 
 int main() {
 	
+#if defined(_MSC_VER)
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
-	// test_parse();
-	// printf("%d/%d (%3.2f%%) passed\n", test_pass, test_count, test_pass * 100.0 / test_count);
-	// system("pause");
-	// return main_ret;
-
-	char str[9999];
-	int cur;
-	int c;
-	FILE *file;
-	cur = 0;
-	file = fopen("origin.txt", "r");
-	while ((c = getc(file)) != EOF) str[cur++] = c;	
-	fclose(file);
-	str[cur] = '\0';
-	lept_value tmp;
-
-	printf("Now parse...\n");
-	int ret = lept_parse(&tmp, str);	
-	if (ret != LEPT_PARSE_OK) printf("Error code %d.\n", ret);
-	else printf("OK\n");
-	
-	printf("Now stringfy...\n");
-	int len = -1;
-	char* outputstr;
-	ret = lept_stringify(&tmp, &outputstr, &len);
-	if (ret != LEPT_STRINGIFY_OK) printf("Error code %d.\n", ret);
-	else printf("OK\n");
-	
-
-	printf("%s\n%d", outputstr, len);
-
-	free(outputstr);
-	lept_free(&tmp);
-	// printf("%s", str);
+#endif
+	test_parse();
+	printf("%d/%d (%3.2f%%) passed\n", test_pass, test_count, test_pass * 100.0 / test_count);
+#if defined(_MSC_VER)
 	system("pause");
-
+#endif
 	return main_ret;
 }